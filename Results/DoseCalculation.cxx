@@ -4,6 +4,10 @@
 #include <TROOT.h>
 #include <iostream>
 
+// Ancestry flags of the fAncestry column, see TrackInformation.hh
+const Int_t kFromB10Capture = 1 << 0;
+const Int_t kCreatedByPhoton = 1 << 4;
+
 // A derived class for specific analysis
 class DoseCalculation : public TreeReader {
 private:
@@ -25,6 +29,9 @@ private:
   Double_t StopingPower;
   Char_t CreatorProcessName[30];
   Char_t PVatVertexname[30];
+  Int_t Ancestry;
+  Bool_t HasAncestry;
+  Double_t Weight;
   //************************************************************************************//
 
 public:
@@ -51,6 +58,9 @@ public:
     StopingPower = 0;
     std::fill(std::begin(CreatorProcessName), std::end(CreatorProcessName),
               0.0); // Fills all elements with 0
+    Ancestry = 0;
+    HasAncestry = false;
+    Weight = 1.;
     //************************************************************************************//
   }
 
@@ -75,6 +85,13 @@ public:
     GetTree()->SetBranchAddress("StopPower", &StopingPower);
     GetTree()->SetBranchAddress("fCreatorProcessName", &CreatorProcessName);
     GetTree()->SetBranchAddress("fPVatVertexname", &PVatVertexname);
+    // Ancestry flags, absent from files written before they were added
+    HasAncestry = (GetTree()->GetBranch("fAncestry") != nullptr);
+    if (HasAncestry)
+      GetTree()->SetBranchAddress("fAncestry", &Ancestry);
+    // Track weight, absent from files written before it was added
+    if (GetTree()->GetBranch("fWeight") != nullptr)
+      GetTree()->SetBranchAddress("fWeight", &Weight);
     //************************************************************************************//
   }
 
@@ -116,6 +133,7 @@ public:
     std::vector<Double_t> v_StopPower;
     std::vector<std::string> v_fCreatorProcessName;
     std::vector<std::string> v_fPVatVertexname;
+    std::vector<Int_t> v_fAncestry;
     //************************************************************************************//
 
     //************************************************************************************//
@@ -132,13 +150,22 @@ public:
       v_posParticleZ.push_back(posParticle[2]);
       v_interactionType.push_back(InteractionType);
       v_targetIsotope.push_back(TargetIsotope);
-      v_edepStep.push_back(edepStep);
+      // Weighted deposit, so that every TID sum below honours the weight
+      v_edepStep.push_back(edepStep * Weight);
       v_StopTable.push_back(StopingTable);
       v_StopFull.push_back(StopingFull);
       v_MeandEdx.push_back(MeandEdX);
       v_StopPower.push_back(StopingPower);
       v_fCreatorProcessName.push_back(CreatorProcessName);
       v_fPVatVertexname.push_back(PVatVertexname);
+      // Without the column, the electrons from compt and phot are taken as
+      // created by a photon, as before the flags were added
+      if (!HasAncestry)
+        Ancestry = (std::string(CreatorProcessName) == "compt" ||
+                    std::string(CreatorProcessName) == "phot")
+                       ? kCreatedByPhoton
+                       : 0;
+      v_fAncestry.push_back(Ancestry);
       //   std::cout<< i << " " << InteractionType << std::endl;
       //   std::cin.get();
     }
@@ -417,6 +444,7 @@ public:
     Double_t TID_gamma = 0.;
     Double_t TID_proton = 0.;
     Double_t TID_nucleus = 0.;
+    Double_t TID_B10Capture = 0.;
     //************************************************************************************//
     // Total TID
     //************************************************************************************//
@@ -448,11 +476,12 @@ public:
     // We would like to calculate the energy deposition of electron coming to
     // the slab from outside of the slab. Secondary electrons due to
     // comptonscattering are created inside the slab. So their deposition will
-    // be counted as gamma deposition.
+    // be counted as gamma deposition. The electrons created by a photon
+    // (compt, phot, conv, ...) are flagged in the fAncestry column.
 
     for (long unsigned int j = 0; j < v_evt.size(); j++) {
-      if (v_fParticleName[j] == "e-" && v_fCreatorProcessName[j] != "compt" &&
-          v_fCreatorProcessName[j] != "phot") {
+      if (v_fParticleName[j] == "e-" &&
+          (v_fAncestry[j] & kCreatedByPhoton) == 0) {
         TID_electron = TID_electron + v_edepStep[j] *
                                           (Joule_conversion / (mass)) *
                                           100.; // in rad
@@ -481,8 +510,8 @@ public:
         TID_gamma =
             TID_gamma + v_edepStep[j] * (Joule_conversion / (mass)) * 100.;
       }
-      if (v_fParticleName[j] == "e-" && (v_fCreatorProcessName[j] == "compt" ||
-                                         v_fCreatorProcessName[j] == "phot")) {
+      if (v_fParticleName[j] == "e-" &&
+          (v_fAncestry[j] & kCreatedByPhoton) != 0) {
         TID_gamma = TID_gamma + v_edepStep[j] * (Joule_conversion / (mass)) *
                                     100.; // in rad
       }
@@ -511,6 +540,15 @@ public:
       }
     }
     //************************************************************************************//
+    // TID from the descendants of the neutrons absorbed by 10B
+    //************************************************************************************//
+    for (long unsigned int j = 0; j < v_evt.size(); j++) {
+      if ((v_fAncestry[j] & kFromB10Capture) != 0) {
+        TID_B10Capture = TID_B10Capture +
+                         v_edepStep[j] * (Joule_conversion / (mass)) * 100.;
+      }
+    }
+    //************************************************************************************//
     // Print the results
     //************************************************************************************//
     std::cout << "Total TID in the " << histtitle.c_str()
@@ -524,6 +562,13 @@ public:
               << " slab: " << TID_proton * scale * 1E6 << " urad" << std::endl;
     std::cout << "Total TID nucleus in the " << histtitle.c_str()
               << " slab: " << TID_nucleus * scale * 1E6 << " urad" << std::endl;
+    std::cout << "Total TID from 10B captures in the " << histtitle.c_str()
+              << " slab: " << TID_B10Capture * scale * 1E6 << " urad"
+              << std::endl;
+    if (!HasAncestry)
+      std::cout << "  (no fAncestry column in the file, the TID from 10B "
+                   "captures is not available)"
+                << std::endl;
     //************************************************************************************//
 
     //************************************************************************************//
@@ -540,6 +585,8 @@ public:
     outFile << "TID gamma (urad): " << TID_gamma * scale * 1E6 << "\n";
     outFile << "TID proton (urad): " << TID_proton * scale * 1E6 << "\n";
     outFile << "TID nucleus (urad): " << TID_nucleus * scale * 1E6 << "\n";
+    outFile << "TID from 10B captures (urad): " << TID_B10Capture * scale * 1E6
+            << "\n";
     outFile.close();
     //************************************************************************************//
   } // End of Anlyze function
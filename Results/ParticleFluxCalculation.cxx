@@ -21,6 +21,7 @@ private:
   Char_t TargetIsotope[20];
   Char_t CreatorProcessName[30];
   Char_t PVatVertexname[30];
+  Double_t Weight;
   //************************************************************************************//
 
 public:
@@ -43,6 +44,7 @@ public:
     std::fill(std::begin(TargetIsotope), std::end(TargetIsotope), 0.0);
     std::fill(std::begin(CreatorProcessName), std::end(CreatorProcessName),
               0.0);
+    Weight = 1.;
     //************************************************************************************//
   }
 
@@ -63,6 +65,9 @@ public:
     GetTree()->SetBranchAddress("targetIsotope", &TargetIsotope);
     GetTree()->SetBranchAddress("fCreatorProcessName", &CreatorProcessName);
     GetTree()->SetBranchAddress("fPVatVertexname", &PVatVertexname);
+    // Track weight, absent from files written before it was added
+    if (GetTree()->GetBranch("fWeight") != nullptr)
+      GetTree()->SetBranchAddress("fWeight", &Weight);
 
     //************************************************************************************//
   }
@@ -107,6 +112,7 @@ public:
     std::vector<std::string> v_targetIsotope;
     std::vector<std::string> v_fCreatorProcessName;
     std::vector<std::string> v_fPVatVertexname;
+    std::vector<Double_t> v_fWeight;
     //************************************************************************************//
     //************************************************************************************//
     // Loop through events and fill vectors
@@ -126,6 +132,7 @@ public:
       v_targetIsotope.push_back(TargetIsotope);
       v_fCreatorProcessName.push_back(CreatorProcessName);
       v_fPVatVertexname.push_back(PVatVertexname);
+      v_fWeight.push_back(Weight);
       //   std::cout<< i << " " << InteractionType << std::endl;
       //   std::cin.get();
     }
@@ -175,11 +182,11 @@ public:
       Double_t y = v_posParticleY[j];
       Double_t z = v_posParticleZ[j];
       if (particleHistMap.find(particle) != particleHistMap.end() && z > 499.) {
-        particleHistMap[particle]->Fill(x, y);
+        particleHistMap[particle]->Fill(x, y, v_fWeight[j]);
         // particlePosMap[particle]->Fill(v_posParticleZ[j]);
       }
       if (particlePosMap.find(particle) != particlePosMap.end() && z > 499.) {
-        particlePosMap[particle]->Fill(v_posParticleZ[j]);
+        particlePosMap[particle]->Fill(v_posParticleZ[j], v_fWeight[j]);
       }
     } // end of filling histograms
 
@@ -0,0 +1,84 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file Checkpoint.hh
+/// \brief Definition of the Checkpoint class
+//
+// Snapshots of a run, to continue it after a crash (/run/checkpoint/,
+// /run/resume). Every N events the end of event writes to the checkpoint
+// file the number of events processed and to process, the state of the
+// random engine, the accumulators of the Run and the contents of the
+// histograms. It then closes the analysis file, which only gets the
+// ntuples, the rows of the following events going to <fileName>_<k>. The
+// histograms are only written to the last file.
+//
+// /run/resume reads the file back at the start of a run of the remaining
+// events, which opens the chunk <fileName>_<k> again. With the macro of
+// the interrupted run (geometry, physics, histogram binnings) the events
+// that follow are the ones the interrupted run would have processed.
+//
+// In MT the events are not processed in order and all the threads would
+// have to stop for a snapshot: the checkpoints are only taken in
+// sequential mode.
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef Checkpoint_h
+#define Checkpoint_h 1
+
+#include "globals.hh"
+
+class HistoManager;
+class Run;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class Checkpoint
+{
+  public:
+    // 0 turns the checkpoints off
+    static void SetInterval(G4int nbOfEvents);
+    static void SetFileName(const G4String&);
+
+    // /run/resume: reads the header of a checkpoint, false if the file is
+    // not one. The next run restores it and processes nbOfEventsLeft events
+    static G4bool Resume(const G4String& fileName, G4int& nbOfEventsLeft);
+
+    // RunAction, begin of run: restores a pending resume, before the
+    // analysis file is opened. False if the checkpoint cannot be restored
+    static G4bool BeginOfRun(Run*, HistoManager*);
+    // RunAction, end of run, after the analysis file is closed
+    static void EndOfRun();
+    // EventAction, end of event, once its rows are written
+    static void EndOfEvent(const Run*);
+
+    // Events of the run the checkpoint was taken from, added to the event ids
+    static G4int GetEventOffset();
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
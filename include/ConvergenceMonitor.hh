@@ -0,0 +1,109 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ConvergenceMonitor.hh
+/// \brief Definition of the ConvergenceMonitor class
+//
+// Relative statistical error of the mean of one per-event tally, estimated
+// with Welford's algorithm, to end a run once a target precision is reached
+// (/run/beamOnUntil). The tallies are
+//   edep            energy deposit of the event
+//   eflow           energy leaving the world
+//   slab<i>         energy deposit in the monitor slab i (1 to NbOfAbsor),
+//                   the relative error of its TID
+//   flux:<particle> number of particles of a species leaving the world
+//
+// Each worker collects its events in a batch and merges the batch into the
+// estimate shared by all threads every kBatchSize events. Once the shared
+// estimate reaches the target a flag is raised, and every worker ends its
+// event loop after its current event.
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef ConvergenceMonitor_h
+#define ConvergenceMonitor_h 1
+
+#include "globals.hh"
+
+class G4ParticleDefinition;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class ConvergenceMonitor
+{
+  public:
+    enum Kind
+    {
+      kOff,
+      kEdep,
+      kEflow,
+      kSlabEdep,
+      kFlux
+    };
+
+    struct Tally
+    {
+        Kind fKind = kOff;
+        G4int fSlab = -1;  // kSlabEdep, index of DetectorConstruction::GetAbsorberIndex
+        const G4ParticleDefinition* fParticle = nullptr;  // kFlux
+        G4String fName;
+    };
+
+    // Running mean and sum of squared deviations of the per-event values
+    struct Welford
+    {
+        void Add(G4double value);
+        // Chan et al. update, for the batches of the threads
+        void Merge(const Welford&);
+        // Relative error of the mean, DBL_MAX while undefined
+        G4double GetRelativeError() const;
+
+        G4long fCount = 0;
+        G4double fMean = 0.;
+        G4double fM2 = 0.;
+    };
+
+    static constexpr G4int kBatchSize = 100;
+    // no decision is taken on fewer events
+    static constexpr G4long kMinEvents = 1000;
+
+  public:
+    // Master, before the run: parses the tally, false if it is unknown
+    static G4bool Start(const G4String& tally, G4double relativeError, G4int nbOfAbsor);
+    static void Stop();
+
+    static Tally GetTally();
+    static G4double GetTarget();
+
+    // Workers: merges a batch into the shared estimate, true once the
+    // target is reached
+    static G4bool AddBatch(const Welford&);
+    static G4bool IsConverged();
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
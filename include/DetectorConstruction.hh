@@ -36,11 +36,27 @@
 #include "G4VUserDetectorConstruction.hh"
 #include "globals.hh"
 
+#include <utility>
+#include <vector>
+
 class G4LogicalVolume;
 class G4Material;
+class G4VPhysicalVolume;
 class DetectorMessenger;
 const G4int kMaxAbsor = 10; // 0 + 9
 
+// Volumes carrying a ScoringSD. Everything else (world air, monitor slabs)
+// is kNotScored.
+enum ScoringVolume : G4int {
+  kNotScored = -1,
+  kBoronConverter = 0,
+  kSiliconY1,
+  kSiliconY2,
+  kSiliconZ1,
+  kSiliconZ2,
+  kNbScoringVolumes
+};
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 class DetectorConstruction : public G4VUserDetectorConstruction {
@@ -50,6 +66,7 @@ public:
 
 public:
   G4VPhysicalVolume *Construct() override;
+  void ConstructSDandField() override;
 
   G4Material *MaterialWithSingleIsotope(G4String, G4String, G4double, G4int,
                                         G4int);
@@ -81,12 +98,18 @@ public:
   G4Material *GetAbsorMaterial_Slab(G4int i) { return fAbsorMaterial_Slab[i]; };
   G4double GetAbsorThickness(G4int i) { return fAbsorThickness[i]; };
   G4double GetXfront(G4int i) { return fXfront[i]; };
+  // Slab number (0 to NbOfAbsor-1) of a volume, -1 if it is not a slab
+  G4int GetAbsorberIndex(const G4VPhysicalVolume *) const;
+  // Mass of a scoring volume, summed over all its layers, 0 if it is not built
+  G4double GetScoringMass(ScoringVolume) const;
 
   G4double GetAbsorSizeX() { return fAbsorSizeX; };
   G4double GetAbsorSizeYZ() { return fAbsorSizeYZ; };
 
   G4double GetWorldSizeX() { return fWorldSizeX; };
   G4double GetWorldSizeYZ() { return fWorldSizeYZ; };
+  G4double GetWorldSizeY() { return fWorldSizeY; };
+  G4double GetWorldSizeZ() { return fWorldSizeZ; };
 
   void PrintParameters();
 
@@ -122,6 +145,10 @@ private:
 
   G4int CreateSiliconSlabs = 0;
 
+  // Filled by ConstructVolumes(), read by ConstructSDandField()
+  std::vector<std::pair<G4LogicalVolume *, ScoringVolume>> fScoringVolumes;
+  std::vector<const G4VPhysicalVolume *> fAbsorberVolumes;
+
 private:
   void DefineMaterials();
   G4VPhysicalVolume *ConstructVolumes();
@@ -33,9 +33,21 @@
 #ifndef EventAction_h
 #define EventAction_h 1
 
+#include "ConvergenceMonitor.hh"
+#include "DetectorConstruction.hh"
+#include "Ntuples.hh"
+#include "StoppingPowerCache.hh"
+#include "TrajectoryStore.hh"
+
 #include "G4UserEventAction.hh"
 #include "globals.hh"
 
+#include <vector>
+
+class G4VHitsCollection;
+class Run;
+class ScoringHit;
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 class EventAction : public G4UserEventAction
@@ -50,10 +62,93 @@ class EventAction : public G4UserEventAction
 
     void AddEdep(G4double Edep);
     void AddEflow(G4double Eflow);
+    void SaveSiliconEdepData(G4int val) { fSaveSiliconData = val; };
+    void SaveSiliconSegmentData(G4int val) { fSaveSiliconSegments = val; };
+    StoppingPowerCache& GetStoppingPowerCache() { return fStoppingPower; };
+
+    // Rows recorded by SteppingAction are staged here and only reach the
+    // ntuples if the event passes the triggers
+    void StageNeutronCapture(const NeutronCaptureRow& row)
+    {
+      fNeutronCaptureRows.push_back(row);
+    };
+    void StageExitWorld(const ExitWorldRow& row) { fExitWorldRows.push_back(row); };
+
+    // Per-track summary: TrackingAction starts and ends the row of the
+    // current track, SteppingAction adds the slab deposits. Null when off.
+    void SaveTrackSummaryData(G4int val) { fSaveTrackSummary = val; };
+    TrackSummaryRow* GetTrackSummary()
+    {
+      return (fSaveTrackSummary == 1) ? &fTrackSummary : nullptr;
+    };
+    void StageTrackSummary() { fTrackSummaryRows.push_back(fTrackSummary); };
+
+    // Event triggers, an event is written if any of them fires. Without
+    // triggers every event is written.
+    void SetCaptureTrigger(G4bool val) { fCaptureTrigger = val; };
+    void SetEdepTrigger(ScoringVolume volume, G4double threshold)
+    {
+      fEdepTrigger[volume] = threshold;
+    };
+    void ClearTriggers();
+
+    // Compact trajectories of the last events, see /stepping/trajectory/.
+    // Null when off.
+    TrajectoryStore* GetTrajectoryStore()
+    {
+      return fTrajectories.IsActive() ? &fTrajectories : nullptr;
+    };
+
+    // Tally of /run/beamOnUntil: SteppingAction adds the deposit in the
+    // monitored slab, TrackingAction the monitored particles leaving the world
+    G4int GetMonitoredSlab() const
+    {
+      return (fTally.fKind == ConvergenceMonitor::kSlabEdep) ? fTally.fSlab : -1;
+    };
+    const G4ParticleDefinition* GetMonitoredParticle() const { return fTally.fParticle; };
+    void AddTallyValue(G4double value) { fTallyValue += value; };
 
   private:
+    G4bool HasTriggers() const;
+    G4bool PassesTriggers(const G4Event*);
+    G4bool HasConverterCapture(const G4Event*);
+    G4double GetScoredEdep(const G4Event*, ScoringVolume);
+    G4VHitsCollection* GetHitsCollection(const G4Event*, ScoringVolume, G4int collection);
+    void WriteStagedRows();
+    // Adds the tally of the event to the run and to the batch of the
+    // thread, ends the event loop once the target precision is reached
+    void EndOfEventTally(Run*);
+    // Adds the energy deposits of the scoring volumes to the dose of the run
+    void AddDose(const G4Event*, Run*);
+
+    // Writes the hits of the scoring sensitive detectors to ntuples 1-5,
+    // and the silicon segments to ntuples 7-10
+    void WriteScoringHits(const G4Event*);
+    void WriteSiliconSegments(const G4Event*);
+    void FillSiliconRow(G4int eventID, const ScoringHit*, SiliconEdepRow&);
+
     G4double fTotalEnergyDeposit = 0.;
     G4double fTotalEnergyFlow = 0.;
+    G4int fSaveSiliconData = 0;
+    G4int fSaveSiliconSegments = 0;
+    G4int fScoringHCID[kNbScoringVolumes] = {-1, -1, -1, -1, -1};
+    G4int fSegmentsHCID[kNbScoringVolumes] = {-1, -1, -1, -1, -1};
+    StoppingPowerCache fStoppingPower;
+    G4int fStoppingPowerRunID = -1;
+
+    std::vector<NeutronCaptureRow> fNeutronCaptureRows;
+    std::vector<ExitWorldRow> fExitWorldRows;
+    G4int fSaveTrackSummary = 0;
+    TrackSummaryRow fTrackSummary;
+    std::vector<TrackSummaryRow> fTrackSummaryRows;
+    G4bool fCaptureTrigger = false;
+    // threshold per scoring volume, negative when the trigger is off
+    G4double fEdepTrigger[kNbScoringVolumes] = {-1., -1., -1., -1., -1.};
+    TrajectoryStore fTrajectories;
+    ConvergenceMonitor::Tally fTally;
+    ConvergenceMonitor::Welford fTallyBatch;
+    G4double fTallyValue = 0.;
+    G4int fTallyRunID = -1;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -33,20 +33,101 @@
 #ifndef HistoManager_h
 #define HistoManager_h 1
 
+#include "LogH1.hh"
+#include "SparseH2.hh"
+
 #include "G4AnalysisManager.hh"
 #include "globals.hh"
 
+#include <iosfwd>
+#include <vector>
+
+class HistoMessenger;
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+// Particles leaving the world, per ParticleClassifier category (10) and
+// world face (6, in the order of TrackingAction::Face):
+//   H1 4-13    energy spectrum per category
+//   H1 14-73   energy spectrum per category and face, 14 + category + 10 * face
+//   H2 0-59    fluence map per category and face, category + 10 * face
+// H1 0-13 are booked at start-up, inactive until their binning is set with
+// /testhadr/flux/ or /analysis/h1/set. The per-face spectra and the maps are
+// only booked, as a block so that the ids above hold, by the first
+// spectrumBinning or mapBinning. With sparseMaps the maps are SparseH2 held
+// by the Run instead, and written to the FluxMap_Sparse ntuple. With
+// logSpectrumBinning the spectra are filled as LogH1 in the Run, and copied
+// into the H1 at the end of the run.
+
 class HistoManager
 {
+  public:
+    static constexpr G4int kNbFaces = 6;
+    static constexpr G4int kNbMaps = 60;  // categories * faces
+    static constexpr G4int kFirstSpectrum = 4;
+    static constexpr G4int kFirstFaceSpectrum = 14;
+
   public:
     HistoManager();
-    ~HistoManager() = default;
+    ~HistoManager();
+
+    // Manager of the calling thread, nullptr if there is none
+    static HistoManager* Instance();
+
+    // Binning of all the maps (-halfWidth to halfWidth on both axes) and of
+    // all the spectra (binScheme linear or log), books and activates them
+    void SetMapBinning(G4int nbins, G4double halfWidth, const G4String& unit);
+    void SetSpectrumBinning(G4int nbins, G4double emin, G4double emax, const G4String& unit,
+                            const G4String& binScheme);
+    // Same, with LogH1 binning (binsPerOctave bins per factor 2 in energy)
+    void SetLogSpectrumBinning(G4int binsPerOctave, G4double emin, G4double emax,
+                               const G4String& unit);
+    void SetNormalisation(G4bool val) { fNormalise = val; };
+    // Maps as SparseH2 in the Run instead of dense H2
+    void SetSparseMaps(G4bool);
+
+    // What TrackingAction may fill
+    G4bool HasFaceSpectra() const { return fFaceSpectraBooked; };
+    G4bool HasDenseMaps() const { return fMapsBooked && !fSparseMaps; };
+    G4bool HasSparseMaps() const { return fSparseMaps && fMapNbins > 0; };
+    G4bool HasLogSpectra() const { return fLogSpectra; };
+    // Empty map with the mapBinning binning, in internal units
+    SparseH2 NewSparseMap() const;
+    // Empty spectrum with the logSpectrumBinning binning
+    LogH1 NewLogSpectrum() const;
+
+    // Master, end of run: spectra per primary, maps per primary and unit
+    // area (mapBinning binning)
+    void NormaliseFluxHistograms(G4int nbOfPrimaries);
+    // Master, end of run: merged log spectra, indexed by H1 id - kFirstSpectrum,
+    // into the H1 (before NormaliseFluxHistograms)
+    void WriteLogSpectra(const std::vector<LogH1>&);
+    // Master, end of run: merged sparse maps, normalised the same way
+    void WriteSparseMaps(const std::vector<SparseH2>&, G4int nbOfPrimaries);
+
+    // Contents of all the booked H1 and H2, for the checkpoints. Restore
+    // needs the same histograms booked with the same binning
+    void SaveHistograms(std::ostream&) const;
+    G4bool RestoreHistograms(std::istream&);
 
   private:
     void Book();
+    void BookMaps();
+    void BookFaceSpectra();
     G4String fFileName = "NeutronSource";
+
+    G4bool fNormalise = false;  // raw counts unless /testhadr/flux/normalise
+    G4bool fSparseMaps = false;
+    G4bool fMapsBooked = false;
+    G4bool fFaceSpectraBooked = false;
+    G4int fMapNbins = 0;
+    G4double fMapHalfWidth = 0.;
+    G4String fMapUnit = "mm";
+    G4bool fLogSpectra = false;
+    G4int fBinsPerOctave = 0;
+    G4double fLogEmin = 0., fLogEmax = 0.;
+    G4String fLogUnit = "MeV";
+    HistoMessenger* fHistoMessenger = nullptr;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,84 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file LogH1.hh
+/// \brief Definition of the LogH1 class
+//
+// 1D histogram with logarithmic bins for the energy spectra, which span
+// from thermal neutrons (25 meV) to the MeV of the source. The bins are
+// the octaves [2^(e-1), 2^e) given by the exponent of the value, each
+// cut into binsPerOctave equal bins of the mantissa: the bin of a value
+// is found with std::frexp, without log() or a search over the edges.
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef LogH1_h
+#define LogH1_h 1
+
+#include "globals.hh"
+
+#include <iosfwd>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class LogH1
+{
+  public:
+    LogH1() = default;
+    // From the octave of xmin to the one of xmax, both > 0
+    LogH1(G4double xmin, G4double xmax, G4int binsPerOctave);
+
+    void Fill(G4double x, G4double weight = 1.);
+    // Adds a histogram with the same binning
+    void Merge(const LogH1&);
+    void Reset();
+    // Binning and filled bins, for the checkpoints
+    void Save(std::ostream&) const;
+    G4bool Restore(std::istream&);
+
+    G4int GetNbins() const { return fNbOctaves * fBinsPerOctave; };
+    // nbins + 1 edges, the range covers xmin and xmax
+    std::vector<G4double> GetEdges() const;
+    // bin 0 is the underflow, nbins + 1 the overflow
+    G4double GetEntries(G4int bin) const { return fEntries[bin]; };
+    G4double GetSumW(G4int bin) const { return fSumW[bin]; };
+    G4double GetSumW2(G4int bin) const { return fSumW2[bin]; };
+    // Centre of the bin 1 to nbins
+    G4double GetBinCenter(G4int bin) const;
+
+  private:
+    G4int fMinExponent = 0;
+    G4int fNbOctaves = 0;
+    G4int fBinsPerOctave = 1;
+    std::vector<G4double> fEntries;
+    std::vector<G4double> fSumW;
+    std::vector<G4double> fSumW2;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
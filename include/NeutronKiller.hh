@@ -0,0 +1,120 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file NeutronKiller.hh
+/// \brief Definition of the NeutronKiller class
+//
+// Kills the neutrons which can no longer contribute to the scored
+// quantities, in the spirit of G4NeutronKiller: below a kinetic energy,
+// after a global time, or outside an envelope around the monitor while
+// moving away from it (the straight line from the track misses the
+// envelope). The energy and time limits are given per region, regions
+// without their own energy or time limit use the one of "all".
+//
+// The settings are shared by the process instances of all threads. They
+// are changed by the master between runs (PhysicsList commands) and copied
+// by each instance at the start of the next track. Kills are counted per
+// reason in Run.
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NeutronKiller_h
+#define NeutronKiller_h 1
+
+#include "G4ThreeVector.hh"
+#include "G4VDiscreteProcess.hh"
+#include "globals.hh"
+
+#include <utility>
+#include <vector>
+
+class G4Region;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class NeutronKiller : public G4VDiscreteProcess
+{
+  public:
+    enum Reason
+    {
+      kEnergy,
+      kTime,
+      kEnvelope,
+      kNbReasons
+    };
+
+    struct Limits
+    {
+        G4double fEnergy = 0.;  // kill below, 0 disables
+        G4double fTime = DBL_MAX;  // kill after, DBL_MAX disables
+    };
+
+  public:
+    explicit NeutronKiller(const G4String& name = "nKiller");
+    ~NeutronKiller() override = default;
+
+    G4bool IsApplicable(const G4ParticleDefinition&) override;
+    void StartTracking(G4Track*) override;
+
+    G4double PostStepGetPhysicalInteractionLength(const G4Track&, G4double,
+                                                  G4ForceCondition*) override;
+    G4VParticleChange* PostStepDoIt(const G4Track&, const G4Step&) override;
+
+    static const char* GetReasonName(G4int reason);
+
+    // Shared settings. region "all" sets the default limits.
+    static void SetEnergyLimit(const G4String& region, G4double energy);
+    static void SetTimeLimit(const G4String& region, G4double time);
+    // Half lengths of a box centred on the monitor, zero disables
+    static void SetEnvelope(const G4ThreeVector& halfLengths);
+    // Centre of the slab stack, set by DetectorConstruction when it builds it
+    static void SetEnvelopeCentre(const G4ThreeVector& centre);
+    static void PrintSettings();
+
+  protected:
+    G4double GetMeanFreePath(const G4Track&, G4double, G4ForceCondition*) override
+    {
+      return DBL_MAX;
+    };
+
+  private:
+    Reason ReasonToKill(const G4Track&) const;
+    void Update();
+
+    // copy of the shared settings, with the region names resolved
+    G4int fVersion = -1;
+    G4bool fActive = false;
+    Limits fDefaultLimits;
+    std::vector<std::pair<const G4Region*, Limits>> fRegionLimits;
+    G4ThreeVector fEnvelope;
+    G4ThreeVector fCentre;
+
+    Reason fReason = kNbReasons;  // set for the step being limited
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,234 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file NtupleRecorder.hh
+/// \brief Definition of the NtupleRecorder class template
+//
+// Books and fills one ntuple from a row struct. The row declares its columns
+// once, in order, as a tuple of (name, pointer to member):
+//
+//   struct MyRow
+//   {
+//       G4int fEvent = 0;
+//       G4double fX = 0.;
+//       static constexpr auto Columns()
+//       {
+//         return std::make_tuple(NtupleColumn("fEvent", &MyRow::fEvent),
+//                                NtupleColumn("fX", &MyRow::fX));
+//       }
+//   };
+//
+// Book() creates the matching CreateNtuple*Column calls, Fill() expands to
+// one FillNtuple*Column call per member with the column index known at
+// compile time. Supported member types are G4int, G4float, G4double,
+// G4String, const G4String* (a name owned elsewhere, not copied) and
+// std::array of those, booked as one column per element named name_0,
+// name_1, ...
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NtupleRecorder_h
+#define NtupleRecorder_h 1
+
+#include "G4AnalysisManager.hh"
+#include "globals.hh"
+
+#include <array>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+template<typename Row, typename T>
+struct NtupleColumn
+{
+    constexpr NtupleColumn(const char* name, T Row::*member) : fName(name), fMember(member) {}
+    const char* fName;
+    T Row::*fMember;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+// Mapping of the member types to the analysis manager column calls
+
+template<typename T>
+struct NtupleColumnType;
+
+template<>
+struct NtupleColumnType<G4int>
+{
+    static void Create(G4AnalysisManager* m, const char* name) { m->CreateNtupleIColumn(name); }
+    static void Fill(G4AnalysisManager* m, G4int id, G4int col, G4int v)
+    {
+      m->FillNtupleIColumn(id, col, v);
+    }
+};
+
+template<>
+struct NtupleColumnType<G4float>
+{
+    static void Create(G4AnalysisManager* m, const char* name) { m->CreateNtupleFColumn(name); }
+    static void Fill(G4AnalysisManager* m, G4int id, G4int col, G4float v)
+    {
+      m->FillNtupleFColumn(id, col, v);
+    }
+};
+
+template<>
+struct NtupleColumnType<G4double>
+{
+    static void Create(G4AnalysisManager* m, const char* name) { m->CreateNtupleDColumn(name); }
+    static void Fill(G4AnalysisManager* m, G4int id, G4int col, G4double v)
+    {
+      m->FillNtupleDColumn(id, col, v);
+    }
+};
+
+template<>
+struct NtupleColumnType<G4String>
+{
+    static void Create(G4AnalysisManager* m, const char* name) { m->CreateNtupleSColumn(name); }
+    static void Fill(G4AnalysisManager* m, G4int id, G4int col, const G4String& v)
+    {
+      m->FillNtupleSColumn(id, col, v);
+    }
+};
+
+template<>
+struct NtupleColumnType<const G4String*>
+{
+    static void Create(G4AnalysisManager* m, const char* name) { m->CreateNtupleSColumn(name); }
+    static void Fill(G4AnalysisManager* m, G4int id, G4int col, const G4String* v)
+    {
+      m->FillNtupleSColumn(id, col, *v);
+    }
+};
+
+template<typename T, std::size_t N>
+struct NtupleColumnType<std::array<T, N>>
+{
+    static void Create(G4AnalysisManager* m, const char* name)
+    {
+      for (std::size_t i = 0; i < N; ++i) {
+        const std::string element = std::string(name) + "_" + std::to_string(i);
+        NtupleColumnType<T>::Create(m, element.c_str());
+      }
+    }
+    static void Fill(G4AnalysisManager* m, G4int id, G4int col, const std::array<T, N>& v)
+    {
+      for (std::size_t i = 0; i < N; ++i) {
+        NtupleColumnType<T>::Fill(m, id, col + G4int(i), v[i]);
+      }
+    }
+};
+
+// Number of ntuple columns taken by a member
+template<typename T>
+struct NtupleColumnWidth
+{
+    static constexpr std::size_t value = 1;
+};
+
+template<typename T, std::size_t N>
+struct NtupleColumnWidth<std::array<T, N>>
+{
+    static constexpr std::size_t value = N;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+template<typename Row>
+class NtupleRecorder
+{
+  public:
+    NtupleRecorder() = default;
+    ~NtupleRecorder() = default;
+
+  public:
+    // Create the ntuple in the analysis manager of the calling thread
+    G4int Book(const G4String& name, const G4String& title)
+    {
+      G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
+      fNtupleId = analysisManager->CreateNtuple(name, title);
+      std::apply(
+        [analysisManager](const auto&... column) {
+          (NtupleColumnType<ColumnValue<decltype(column)>>::Create(analysisManager, column.fName),
+           ...);
+        },
+        Row::Columns());
+      analysisManager->FinishNtuple(fNtupleId);
+      return fNtupleId;
+    };
+
+    // Add one row
+    void Fill(const Row& row) const
+    {
+      FillColumns(G4AnalysisManager::Instance(), row,
+                  std::make_index_sequence<std::tuple_size_v<decltype(Row::Columns())>>());
+      G4AnalysisManager::Instance()->AddNtupleRow(fNtupleId);
+    };
+
+    G4int GetNtupleId() const { return fNtupleId; };
+
+  private:
+    template<typename Column>
+    using ColumnValue = std::remove_cv_t<
+      std::remove_reference_t<decltype(std::declval<Row>().*(std::declval<Column>().fMember))>>;
+
+    // Index of the first ntuple column of each member
+    template<std::size_t... I>
+    static constexpr auto ColumnOffsets(std::index_sequence<I...>)
+    {
+      constexpr auto columns = Row::Columns();
+      constexpr std::size_t widths[] = {
+        NtupleColumnWidth<ColumnValue<decltype(std::get<I>(columns))>>::value...};
+      std::array<G4int, sizeof...(I)> offsets{};
+      G4int offset = 0;
+      for (std::size_t i = 0; i < sizeof...(I); ++i) {
+        offsets[i] = offset;
+        offset += G4int(widths[i]);
+      }
+      return offsets;
+    };
+
+    template<std::size_t... I>
+    void FillColumns(G4AnalysisManager* analysisManager, const Row& row,
+                     std::index_sequence<I...>) const
+    {
+      constexpr auto columns = Row::Columns();
+      constexpr auto offsets = ColumnOffsets(std::index_sequence<I...>());
+      (NtupleColumnType<ColumnValue<decltype(std::get<I>(columns))>>::Fill(
+         analysisManager, fNtupleId, offsets[I], row.*(std::get<I>(columns).fMember)),
+       ...);
+    };
+
+    G4int fNtupleId = -1;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,367 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file Ntuples.hh
+/// \brief Definition of the ntuple rows and of the Ntuples class
+//
+// Schema of the output ntuples. Each row struct lists its columns once; the
+// same declaration books the ntuple (RunAction) and fills it (SteppingAction,
+// EventAction), so the two cannot disagree. Names are kept as pointers to
+// strings owned by Geant4, see StepNames.
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef Ntuples_h
+#define Ntuples_h 1
+
+#include "DetectorConstruction.hh"
+#include "NtupleRecorder.hh"
+
+#include <array>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Neutrons produced by an inelastic hadronic interaction
+struct NeutronCaptureRow
+{
+    G4int fEvent = 0;
+    const G4String* fParticleName = nullptr;
+    G4double fX = 0., fY = 0., fZ = 0.;
+    const G4String* fInteractionType = nullptr;
+    const G4String* fTargetIsotope = nullptr;
+    G4int fAncestry = 0;
+    G4double fWeight = 1.;  // track weight
+
+    static constexpr auto Columns()
+    {
+      using R = NeutronCaptureRow;
+      return std::make_tuple(NtupleColumn("fEvent", &R::fEvent),
+                             NtupleColumn("fParticleName", &R::fParticleName),
+                             NtupleColumn("fX", &R::fX), NtupleColumn("fY", &R::fY),
+                             NtupleColumn("fZ", &R::fZ),
+                             NtupleColumn("fInteractionType", &R::fInteractionType),
+                             NtupleColumn("targetIsotope", &R::fTargetIsotope),
+                             NtupleColumn("fAncestry", &R::fAncestry),
+                             NtupleColumn("fWeight", &R::fWeight));
+    };
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Steps in the boron converter
+struct BoronEdepRow
+{
+    G4int fEvent = 0;
+    const G4String* fParticleName = nullptr;
+    G4int fParentID = 0, fParticleID = 0, fStepNumber = 0;
+    G4double fX = 0., fY = 0., fZ = 0.;
+    const G4String* fInteractionType = nullptr;
+    const G4String* fTargetIsotope = nullptr;
+    G4double fEdep = 0.;
+    const G4String* fCreatorProcessName = nullptr;
+    G4int fAncestry = 0;
+    G4double fWeight = 1.;  // track weight
+
+    static constexpr auto Columns()
+    {
+      using R = BoronEdepRow;
+      return std::make_tuple(
+        NtupleColumn("fEvent", &R::fEvent), NtupleColumn("fParticleName", &R::fParticleName),
+        NtupleColumn("fParentID", &R::fParentID), NtupleColumn("fParticleID", &R::fParticleID),
+        NtupleColumn("fStepNumber", &R::fStepNumber), NtupleColumn("fX", &R::fX),
+        NtupleColumn("fY", &R::fY), NtupleColumn("fZ", &R::fZ),
+        NtupleColumn("fInteractionType", &R::fInteractionType),
+        NtupleColumn("targetIsotope", &R::fTargetIsotope), NtupleColumn("Edep", &R::fEdep),
+        NtupleColumn("fCreatorProcessName", &R::fCreatorProcessName),
+        NtupleColumn("fAncestry", &R::fAncestry),
+        NtupleColumn("fWeight", &R::fWeight));
+    };
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Energy depositing steps in the silicon slabs
+struct SiliconEdepRow
+{
+    G4int fEvent = 0;
+    const G4String* fParticleName = nullptr;
+    G4int fParentID = 0, fParticleID = 0, fStepNumber = 0;
+    G4double fX = 0., fY = 0., fZ = 0.;
+    const G4String* fInteractionType = nullptr;
+    const G4String* fTargetIsotope = nullptr;
+    G4double fEdep = 0.;
+    G4double fStopTable = 0., fStopFull = 0., fMeandEdx = 0., fStopPower = 0.;
+    const G4String* fCreatorProcessName = nullptr;
+    const G4String* fVertexVolumeName = nullptr;
+    G4int fAncestry = 0;
+    G4double fWeight = 1.;  // track weight
+
+    static constexpr auto Columns()
+    {
+      using R = SiliconEdepRow;
+      return std::make_tuple(
+        NtupleColumn("fEvent", &R::fEvent), NtupleColumn("fParticleName", &R::fParticleName),
+        NtupleColumn("fParentID", &R::fParentID), NtupleColumn("fParticleID", &R::fParticleID),
+        NtupleColumn("fStepNumber", &R::fStepNumber), NtupleColumn("fX", &R::fX),
+        NtupleColumn("fY", &R::fY), NtupleColumn("fZ", &R::fZ),
+        NtupleColumn("fInteractionType", &R::fInteractionType),
+        NtupleColumn("targetIsotope", &R::fTargetIsotope), NtupleColumn("Edep", &R::fEdep),
+        NtupleColumn("StopTable", &R::fStopTable), NtupleColumn("StopFull", &R::fStopFull),
+        NtupleColumn("MeandEdx", &R::fMeandEdx), NtupleColumn("StopPower", &R::fStopPower),
+        NtupleColumn("fCreatorProcessName", &R::fCreatorProcessName),
+        NtupleColumn("fPVatVertexname", &R::fVertexVolumeName),
+        NtupleColumn("fAncestry", &R::fAncestry),
+        NtupleColumn("fWeight", &R::fWeight));
+    };
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Particles leaving the world volume
+struct ExitWorldRow
+{
+    G4int fEvent = 0;
+    const G4String* fParticleName = nullptr;
+    G4int fParentID = 0, fParticleID = 0, fStepNumber = 0;
+    G4double fX = 0., fY = 0., fZ = 0.;
+    G4double fKinEnergy = 0.;
+    const G4String* fInteractionType = nullptr;
+    const G4String* fTargetIsotope = nullptr;
+    const G4String* fCreatorProcessName = nullptr;
+    const G4String* fVertexVolumeName = nullptr;
+    G4int fAncestry = 0;
+    G4double fWeight = 1.;  // track weight
+
+    static constexpr auto Columns()
+    {
+      using R = ExitWorldRow;
+      return std::make_tuple(
+        NtupleColumn("fEvent", &R::fEvent), NtupleColumn("fParticleName", &R::fParticleName),
+        NtupleColumn("fParentID", &R::fParentID), NtupleColumn("fParticleID", &R::fParticleID),
+        NtupleColumn("fStepNumber", &R::fStepNumber), NtupleColumn("fX", &R::fX),
+        NtupleColumn("fY", &R::fY), NtupleColumn("fZ", &R::fZ),
+        NtupleColumn("fKinEnergy", &R::fKinEnergy),
+        NtupleColumn("fInteractionType", &R::fInteractionType),
+        NtupleColumn("targetIsotope", &R::fTargetIsotope),
+        NtupleColumn("fCreatorProcessName", &R::fCreatorProcessName),
+        NtupleColumn("fPVatVertexname", &R::fVertexVolumeName),
+        NtupleColumn("fAncestry", &R::fAncestry),
+        NtupleColumn("fWeight", &R::fWeight));
+    };
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Passages of a track through a silicon slab (ScoringSegment)
+struct SiliconSegmentRow
+{
+    G4int fEvent = 0;
+    const G4String* fParticleName = nullptr;
+    G4int fParentID = 0, fParticleID = 0;
+    G4double fEntryX = 0., fEntryY = 0., fEntryZ = 0.;
+    G4double fExitX = 0., fExitY = 0., fExitZ = 0.;
+    G4double fEntryKinEnergy = 0.;
+    G4double fEdep = 0.;
+    G4double fTrackLength = 0.;
+    G4double fMeandEdx = 0., fMaxdEdx = 0.;
+    G4int fNbSteps = 0;
+    const G4String* fCreatorProcessName = nullptr;
+    const G4String* fVertexVolumeName = nullptr;
+    G4int fAncestry = 0;
+    G4double fWeight = 1.;  // track weight
+
+    static constexpr auto Columns()
+    {
+      using R = SiliconSegmentRow;
+      return std::make_tuple(
+        NtupleColumn("fEvent", &R::fEvent), NtupleColumn("fParticleName", &R::fParticleName),
+        NtupleColumn("fParentID", &R::fParentID), NtupleColumn("fParticleID", &R::fParticleID),
+        NtupleColumn("fEntryX", &R::fEntryX), NtupleColumn("fEntryY", &R::fEntryY),
+        NtupleColumn("fEntryZ", &R::fEntryZ), NtupleColumn("fExitX", &R::fExitX),
+        NtupleColumn("fExitY", &R::fExitY), NtupleColumn("fExitZ", &R::fExitZ),
+        NtupleColumn("fEntryKinEnergy", &R::fEntryKinEnergy), NtupleColumn("Edep", &R::fEdep),
+        NtupleColumn("fTrackLength", &R::fTrackLength), NtupleColumn("MeandEdx", &R::fMeandEdx),
+        NtupleColumn("MaxdEdx", &R::fMaxdEdx), NtupleColumn("fNbSteps", &R::fNbSteps),
+        NtupleColumn("fCreatorProcessName", &R::fCreatorProcessName),
+        NtupleColumn("fPVatVertexname", &R::fVertexVolumeName),
+        NtupleColumn("fAncestry", &R::fAncestry),
+        NtupleColumn("fWeight", &R::fWeight));
+    };
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// One row per track (/stepping/saveTrackSummary), accumulated while the
+// track is transported and written when it ends
+struct TrackSummaryRow
+{
+    // How the track ended
+    enum Fate : G4int
+    {
+      kEscaped = 0,  // left the world
+      kStopped,  // slowed down to rest by ionisation
+      kInteracted,  // absorbed or destroyed in an interaction
+      kDecayed,
+      kKilled  // user limit (nKiller)
+    };
+    // Monitor slabs, see DetectorConstruction::GetAbsorberIndex
+    static constexpr std::size_t kNbLayers = kMaxAbsor - 1;
+
+    G4int fEvent = 0;
+    const G4String* fParticleName = nullptr;
+    G4int fParentID = 0, fParticleID = 0;
+    G4double fVertexX = 0., fVertexY = 0., fVertexZ = 0.;
+    const G4String* fVertexVolumeName = nullptr;
+    const G4String* fCreatorProcessName = nullptr;
+    G4double fVertexKinEnergy = 0.;
+    G4double fEndX = 0., fEndY = 0., fEndZ = 0.;
+    G4double fEndKinEnergy = 0.;
+    G4double fTrackLength = 0.;
+    G4int fNbSteps = 0;
+    G4int fFate = kEscaped;
+    const G4String* fFateProcessName = nullptr;
+    std::array<G4double, kNbLayers> fLayerEdep{};
+    std::array<G4double, kNbLayers> fLayerLength{};
+    G4int fAncestry = 0;
+    G4double fWeight = 1.;  // track weight
+
+    static constexpr auto Columns()
+    {
+      using R = TrackSummaryRow;
+      return std::make_tuple(
+        NtupleColumn("fEvent", &R::fEvent), NtupleColumn("fParticleName", &R::fParticleName),
+        NtupleColumn("fParentID", &R::fParentID), NtupleColumn("fParticleID", &R::fParticleID),
+        NtupleColumn("fVertexX", &R::fVertexX), NtupleColumn("fVertexY", &R::fVertexY),
+        NtupleColumn("fVertexZ", &R::fVertexZ),
+        NtupleColumn("fLVatVertexname", &R::fVertexVolumeName),
+        NtupleColumn("fCreatorProcessName", &R::fCreatorProcessName),
+        NtupleColumn("fVertexKinEnergy", &R::fVertexKinEnergy),
+        NtupleColumn("fEndX", &R::fEndX), NtupleColumn("fEndY", &R::fEndY),
+        NtupleColumn("fEndZ", &R::fEndZ), NtupleColumn("fEndKinEnergy", &R::fEndKinEnergy),
+        NtupleColumn("fTrackLength", &R::fTrackLength), NtupleColumn("fNbSteps", &R::fNbSteps),
+        NtupleColumn("fFate", &R::fFate), NtupleColumn("fFateProcessName", &R::fFateProcessName),
+        NtupleColumn("LayerEdep", &R::fLayerEdep), NtupleColumn("LayerLength", &R::fLayerLength),
+        NtupleColumn("fAncestry", &R::fAncestry),
+        NtupleColumn("fWeight", &R::fWeight));
+    };
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Total ionising dose of the run per scoring volume and particle class, one
+// row per volume filled by the master at the end of the run (Run::EndOfRun).
+// A dose-only run needs no per-step ntuple.
+struct DoseSummaryRow
+{
+    // Same classes as Results/DoseCalculation.cxx
+    enum DoseClass : G4int
+    {
+      kTotal = 0,
+      kElectron,  // e+, and e- not created by a photon
+      kGamma,  // photons and the e- they create
+      kProton,
+      kNucleus,  // Si and P nuclei
+      kB10Capture,  // descendants of a neutron absorbed by 10B
+      kNbClasses
+    };
+
+    const G4String* fVolumeName = nullptr;
+    G4double fMass = 0.;  // kg, from the solid and material of the volume
+    G4int fNbEvents = 0;
+    std::array<G4double, kNbClasses> fEdep{};  // MeV
+    std::array<G4double, kNbClasses> fDose{};  // Gy
+
+    static constexpr auto Columns()
+    {
+      using R = DoseSummaryRow;
+      return std::make_tuple(
+        NtupleColumn("fVolume", &R::fVolumeName), NtupleColumn("fMass", &R::fMass),
+        NtupleColumn("fNbEvents", &R::fNbEvents), NtupleColumn("Edep", &R::fEdep),
+        NtupleColumn("Dose", &R::fDose));
+    };
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// One filled bin of a sparse fluence map, see /testhadr/flux/sparseMaps
+struct SparseMapRow
+{
+    G4int fMap = 0;  // H2 id of the dense map, category + 10 * face
+    G4int fBinX = 0, fBinY = 0;
+    G4double fX = 0., fY = 0.;  // mm, bin centre
+    G4double fValue = 0., fError = 0.;  // per cm2 and per primary, or counts
+
+    static constexpr auto Columns()
+    {
+      using R = SparseMapRow;
+      return std::make_tuple(
+        NtupleColumn("fMap", &R::fMap), NtupleColumn("fBinX", &R::fBinX),
+        NtupleColumn("fBinY", &R::fBinY), NtupleColumn("fX", &R::fX), NtupleColumn("fY", &R::fY),
+        NtupleColumn("fValue", &R::fValue), NtupleColumn("fError", &R::fError));
+    };
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Recorders of the calling thread, booked by RunAction
+class Ntuples
+{
+  public:
+    static Ntuples* Instance();
+
+    void Book();
+
+    const NtupleRecorder<NeutronCaptureRow>& NeutronCapture() const { return fNeutronCapture; };
+    const NtupleRecorder<BoronEdepRow>& BoronEdep() const { return fBoronEdep; };
+    const NtupleRecorder<SiliconEdepRow>& SiliconEdep(ScoringVolume v) const
+    {
+      return fSiliconEdep[v - kSiliconY1];
+    };
+    const NtupleRecorder<ExitWorldRow>& ExitWorld() const { return fExitWorld; };
+    const NtupleRecorder<SiliconSegmentRow>& SiliconSegment(ScoringVolume v) const
+    {
+      return fSiliconSegment[v - kSiliconY1];
+    };
+    const NtupleRecorder<TrackSummaryRow>& TrackSummary() const { return fTrackSummary; };
+    const NtupleRecorder<DoseSummaryRow>& DoseSummary() const { return fDoseSummary; };
+    const NtupleRecorder<SparseMapRow>& SparseMap() const { return fSparseMap; };
+
+  private:
+    Ntuples() = default;
+
+    NtupleRecorder<NeutronCaptureRow> fNeutronCapture;
+    NtupleRecorder<BoronEdepRow> fBoronEdep;
+    NtupleRecorder<SiliconEdepRow> fSiliconEdep[kSiliconZ2 - kSiliconY1 + 1];
+    NtupleRecorder<ExitWorldRow> fExitWorld;
+    NtupleRecorder<SiliconSegmentRow> fSiliconSegment[kSiliconZ2 - kSiliconY1 + 1];
+    NtupleRecorder<TrackSummaryRow> fTrackSummary;
+    NtupleRecorder<DoseSummaryRow> fDoseSummary;
+    NtupleRecorder<SparseMapRow> fSparseMap;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
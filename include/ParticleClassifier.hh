@@ -0,0 +1,112 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ParticleClassifier.hh
+/// \brief Definition of the ParticleClassifier class
+//
+// Category of a particle for the flux histograms (gamma, e+-, neutron, ...,
+// other ions, baryons, mesons, leptons). The table is keyed by the
+// G4ParticleDefinition pointer, filled with the particles known when the
+// classifier is first used (start of the first run of the thread) and with
+// the ions when they first show up, so that classifying a track costs one
+// lookup instead of a chain of pointer and string comparisons.
+//
+// The same lookup gives the index of the particle for the per-run particle
+// statistics. Indices are handed out by a registry shared by all threads,
+// as the ProcessClassifier codes are, so that the per-thread arrays of Run
+// are merged index by index and the names are only needed at the end of
+// the run.
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef ParticleClassifier_h
+#define ParticleClassifier_h 1
+
+#include "globals.hh"
+
+#include <unordered_map>
+
+class G4ParticleDefinition;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class ParticleClassifier
+{
+  public:
+    // Same order as the flux histograms
+    enum Category : G4int
+    {
+      kUnclassified = -1,
+      kGamma = 0,
+      kElectron,  // e- and e+
+      kNeutron,
+      kProton,
+      kDeuteron,
+      kAlpha,
+      kOtherIon,  // nuclei and charge > 3
+      kOtherBaryon,
+      kOtherMeson,
+      kOtherLepton,
+      kNbCategories
+    };
+
+    struct ParticleInfo
+    {
+        Category fCategory = kUnclassified;
+        G4int fIndex = -1;  // dense, the same on every thread
+    };
+
+  public:
+    // Classifier of the calling thread
+    static ParticleClassifier* Instance();
+
+    const ParticleInfo& GetInfo(const G4ParticleDefinition* particle)
+    {
+      auto it = fTable.find(particle);
+      return (it != fTable.end()) ? it->second : Add(particle);
+    };
+    Category Classify(const G4ParticleDefinition* particle)
+    {
+      return GetInfo(particle).fCategory;
+    };
+
+    // Shared registry: particle of an index, and number of indices so far
+    static const G4ParticleDefinition* GetParticle(G4int index);
+    static G4int GetNbIndices();
+
+  private:
+    ParticleClassifier();
+
+    const ParticleInfo& Add(const G4ParticleDefinition*);
+    static Category Compute(const G4ParticleDefinition*);
+    static G4int Register(const G4ParticleDefinition*);
+
+    std::unordered_map<const G4ParticleDefinition*, ParticleInfo> fTable;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
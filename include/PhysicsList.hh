@@ -34,13 +34,15 @@
 #include "G4VModularPhysicsList.hh"
 #include "globals.hh"
 
+class NeutronKillerMessenger;
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 class PhysicsList : public G4VModularPhysicsList
 {
   public:
     PhysicsList();
-    ~PhysicsList() override = default;
+    ~PhysicsList() override;
 
   public:
     void ConstructProcess() override;
@@ -55,6 +57,8 @@ class PhysicsList : public G4VModularPhysicsList
     G4VPhysicsConstructor* fElectromagnetic = nullptr;
     G4VPhysicsConstructor* fDecay = nullptr;
     G4VPhysicsConstructor* fRadioactiveDecay = nullptr;
+
+    NeutronKillerMessenger* fNeutronKillerMessenger = nullptr;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
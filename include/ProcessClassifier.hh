@@ -0,0 +1,104 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ProcessClassifier.hh
+/// \brief Definition of the ProcessClassifier class
+//
+// Per-thread table of the processes seen while stepping, keyed by the
+// G4VProcess pointer and filled the first time a process shows up. The
+// entry keeps the process category, the hadronic process pointer (one
+// dynamic_cast per process instead of one per step) and an integer code.
+// Codes are handed out by a registry shared by all threads and keyed by
+// process name, so the same process has the same code on every worker and
+// per-thread counts can be merged by code.
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef ProcessClassifier_h
+#define ProcessClassifier_h 1
+
+#include "G4ProcessType.hh"
+#include "globals.hh"
+
+#include <unordered_map>
+
+class G4HadronicProcess;
+class G4VProcess;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+struct ProcessInfo
+{
+    G4int fCode = -1;  // -1 when the step was not limited by a process
+    G4ProcessType fCategory = fNotDefined;
+    G4int fSubType = -1;
+    G4bool fIsHadronic = false;
+    G4HadronicProcess* fHadronic = nullptr;  // set for G4HadronicProcess and derived
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class ProcessClassifier
+{
+  public:
+    // Classifier of the calling thread
+    static ProcessClassifier* Instance();
+
+    const ProcessInfo& Classify(const G4VProcess* process)
+    {
+      if (process == nullptr) return fNoProcess;
+      auto it = fTable.find(process);
+      return (it != fTable.end()) ? it->second : Add(process);
+    };
+
+    // Gives a code to every process attached to a particle, called at the
+    // end of PhysicsList::ConstructProcess so that the codes are dense and
+    // known before the first step. Processes created later are added when
+    // first seen.
+    static void RegisterProcesses();
+
+    // Shared registry: process name of a code, and number of codes so far
+    static G4String GetName(G4int code);
+    static G4int GetNbCodes();
+    // Code of a process name, names not seen yet get a new code so that the
+    // process can be referred to before it is created (checkpoint restore)
+    static G4int GetCode(const G4String& name) { return Register(name); };
+    // Code of a process name, -1 if no process of this name is registered
+    static G4int FindCode(const G4String& name);
+
+  private:
+    ProcessClassifier() = default;
+
+    const ProcessInfo& Add(const G4VProcess*);
+    static G4int Register(const G4String& name);
+
+    std::unordered_map<const G4VProcess*, ProcessInfo> fTable;
+    const ProcessInfo fNoProcess;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
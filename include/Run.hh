@@ -33,11 +33,22 @@
 #ifndef Run_h
 #define Run_h 1
 
+#include "ConvergenceMonitor.hh"
+#include "LogH1.hh"
+#include "NeutronKiller.hh"
+#include "Ntuples.hh"
+#include "SparseH2.hh"
+#include "StepProfile.hh"
+
 #include "G4Run.hh"
 #include "G4VProcess.hh"
 #include "globals.hh"
 
+#include <array>
+#include <cstdint>
+#include <iosfwd>
 #include <map>
+#include <vector>
 
 class DetectorConstruction;
 class G4ParticleDefinition;
@@ -52,29 +63,72 @@ class Run : public G4Run
 
   public:
     void SetPrimary(G4ParticleDefinition* particle, G4double energy);
-    void CountProcesses(const G4VProcess* process);
-    void ParticleCount(G4String, G4double, G4double);
+    void CountProcesses(G4int processCode);
+    // New track killed or deferred by a StackingAction rule
+    void CountStackingRule(G4int ruleId, G4double energy);
+    // Neutron killed by NeutronKiller, reason is a NeutronKiller::Reason
+    void CountNeutronKill(G4int reason, G4double energy);
+    // Secondary with meanLife != 0, and particle leaving the world. The
+    // tallies take the track weight
+    void ParticleCount(const G4ParticleDefinition*, G4double energy, G4double meanLife,
+                       G4double weight = 1.);
     void AddEdep(G4double edep);
     void AddEflow(G4double eflow);
-    void ParticleFlux(G4String, G4double);
+    void ParticleFlux(const G4ParticleDefinition*, G4double energy, G4double weight = 1.);
+    // Energy deposit in a scoring volume, doseClass is a DoseSummaryRow::DoseClass
+    void AddDose(ScoringVolume volume, G4int doseClass, G4double edep)
+    {
+      fDoseEdep[volume][doseClass] += edep;
+    };
+    // Energy of a particle leaving the world, h1 is the H1 id of the spectrum,
+    // see /testhadr/flux/logSpectrumBinning
+    void FillSpectrum(G4int h1, G4double energy, G4double weight = 1.);
+    const std::vector<LogH1>& GetSpectra() const { return fSpectra; };
+    // Position on a world face, map is the H2 id, see /testhadr/flux/sparseMaps
+    void FillFluxMap(G4int map, G4double u, G4double v, G4double weight = 1.);
+    const std::vector<SparseH2>& GetFluxMaps() const { return fFluxMaps; };
+    // Value per event of the /run/beamOnUntil tally
+    void AddTallyValue(G4double value) { fTally.Add(value); };
+#ifdef NEUTRONSOURCE_COUNT_ALLOCATIONS
+    void CountStepAllocations(G4bool recorded, std::uint64_t allocations);
+#endif
+#ifdef NEUTRONSOURCE_PROFILE_STEPPING
+    StepProfile& GetStepProfile() { return fStepProfile; };
+#endif
 
     void Merge(const G4Run*) override;
     void EndOfRun();
 
+    // Accumulators, for the checkpoints. The processes and particles are
+    // saved by name, their codes and indices depend on the job. Restore
+    // also sets the number of events already processed
+    void Save(std::ostream&) const;
+    G4bool Restore(std::istream&, G4int nbOfEvents);
+
   private:
     struct ParticleData
     {
-        ParticleData() : fCount(0), fEmean(0.), fEmin(0.), fEmax(0.), fTmean(-1.) {}
-        ParticleData(G4int count, G4double ekin, G4double emin, G4double emax, G4double meanLife)
-          : fCount(count), fEmean(ekin), fEmin(emin), fEmax(emax), fTmean(meanLife)
-        {}
-        G4int fCount;
-        G4double fEmean;
-        G4double fEmin;
-        G4double fEmax;
-        G4double fTmean;
+        void Add(G4double ekin, G4double meanLife, G4double weight);
+        void Merge(const ParticleData&);
+
+        G4int fCount = 0;
+        G4double fSumW = 0.;  // weighted count
+        G4double fEmean = 0.;  // weighted sum
+        G4double fEmin = 0.;
+        G4double fEmax = 0.;
+        G4double fTmean = -1.;
     };
 
+    // Entry of a particle, the arrays grow with the ParticleClassifier indices
+    static ParticleData& GetParticleData(std::vector<ParticleData>&,
+                                         const G4ParticleDefinition*);
+    static void MergeParticleData(std::vector<ParticleData>&, const std::vector<ParticleData>&);
+    void PrintParticleData(const std::vector<ParticleData>&, G4bool flux);
+    static void SaveParticleData(std::ostream&, const std::vector<ParticleData>&);
+    static G4bool RestoreParticleData(std::istream&, std::vector<ParticleData>&);
+    // TID of the scoring volumes, printed and written to Dose_Summary
+    void WriteDoseSummary();
+
   private:
     DetectorConstruction* fDetector = nullptr;
     G4ParticleDefinition* fParticle = nullptr;
@@ -82,9 +136,28 @@ class Run : public G4Run
 
     G4double fEnergyDeposit = 0., fEnergyDeposit2 = 0.;
     G4double fEnergyFlow = 0., fEnergyFlow2 = 0.;
-    std::map<G4String, G4int> fProcCounter;
-    std::map<G4String, ParticleData> fParticleDataMap1;
-    std::map<G4String, ParticleData> fParticleDataMap2;
+    std::vector<std::uint64_t> fProcCounter;  // indexed by ProcessClassifier code
+    std::vector<std::uint64_t> fStackingCounter;  // indexed by StackingAction rule id
+    std::vector<G4double> fStackingEnergy;  // kinetic energy of those tracks
+    std::array<std::uint64_t, NeutronKiller::kNbReasons> fNeutronKills{};
+    std::array<G4double, NeutronKiller::kNbReasons> fNeutronKillEnergy{};
+    // indexed by ParticleClassifier index
+    std::vector<ParticleData> fCreatedParticles;
+    std::vector<ParticleData> fEmergingParticles;
+    ConvergenceMonitor::Welford fTally;
+    std::array<std::array<G4double, DoseSummaryRow::kNbClasses>, kNbScoringVolumes> fDoseEdep{};
+    // log spectra and sparse fluence maps, allocated by the first fill
+    std::vector<LogH1> fSpectra;
+    std::vector<SparseH2> fFluxMaps;
+#ifdef NEUTRONSOURCE_COUNT_ALLOCATIONS
+    // steps not written to any ntuple, and the heap allocations they made
+    std::uint64_t fUnrecordedSteps = 0;
+    std::uint64_t fUnrecordedStepsAllocating = 0;
+    std::uint64_t fUnrecordedStepAllocations = 0;
+#endif
+#ifdef NEUTRONSOURCE_PROFILE_STEPPING
+    StepProfile fStepProfile;
+#endif
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
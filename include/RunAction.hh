@@ -38,6 +38,8 @@
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+class CheckpointMessenger;
+class ConvergenceMessenger;
 class DetectorConstruction;
 class Run;
 class PrimaryGeneratorAction;
@@ -61,6 +63,8 @@ class RunAction : public G4UserRunAction
     PrimaryGeneratorAction* fPrimary = nullptr;
     Run* fRun = nullptr;
     HistoManager* fHistoManager = nullptr;
+    ConvergenceMessenger* fConvergenceMessenger = nullptr;  // master only
+    CheckpointMessenger* fCheckpointMessenger = nullptr;  // master only
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,125 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ScoringHit.hh
+/// \brief Definition of the ScoringHit class
+//
+// One step in a scoring volume (silicon slab or boron converter), as seen by
+// ScoringSD. Only pointers and numbers are kept; names and stopping powers
+// are resolved by EventAction when the hits are written at end of event.
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef ScoringHit_h
+#define ScoringHit_h 1
+
+#include "G4Allocator.hh"
+#include "G4THitsCollection.hh"
+#include "G4ThreeVector.hh"
+#include "G4VHit.hh"
+#include "globals.hh"
+
+class G4Isotope;
+class G4LogicalVolume;
+class G4Material;
+class G4ParticleDefinition;
+class G4Step;
+class G4VPhysicalVolume;
+class G4VProcess;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class ScoringHit : public G4VHit
+{
+  public:
+    ScoringHit() = default;
+    explicit ScoringHit(const G4Step*);
+    ~ScoringHit() override = default;
+
+    inline void* operator new(size_t);
+    inline void operator delete(void*);
+
+  public:
+    const G4ParticleDefinition* GetParticle() const { return fParticle; };
+    G4int GetParentID() const { return fParentID; };
+    G4int GetTrackID() const { return fTrackID; };
+    G4int GetStepNumber() const { return fStepNumber; };
+    const G4ThreeVector& GetPosition() const { return fPosition; };
+    const G4VProcess* GetProcess() const { return fProcess; };
+    const G4Isotope* GetTargetIsotope() const { return fTargetIsotope; };
+    const G4VPhysicalVolume* GetPostVolume() const { return fPostVolume; };
+    const G4VProcess* GetCreatorProcess() const { return fCreatorProcess; };
+    const G4LogicalVolume* GetVertexVolume() const { return fVertexVolume; };
+    G4int GetAncestry() const { return fAncestry; };
+    G4double GetWeight() const { return fWeight; };
+    const G4Material* GetMaterial() const { return fMaterial; };
+    G4double GetEdep() const { return fEdep; };
+    G4double GetStepLength() const { return fStepLength; };
+    G4double GetPreKineticEnergy() const { return fPreKineticEnergy; };
+
+  private:
+    const G4ParticleDefinition* fParticle = nullptr;
+    G4int fParentID = 0;
+    G4int fTrackID = 0;
+    G4int fStepNumber = 0;
+    G4ThreeVector fPosition;  // post-step point
+    const G4VProcess* fProcess = nullptr;  // process limiting the step
+    const G4Isotope* fTargetIsotope = nullptr;
+    const G4VPhysicalVolume* fPostVolume = nullptr;
+    const G4VProcess* fCreatorProcess = nullptr;
+    const G4LogicalVolume* fVertexVolume = nullptr;
+    G4int fAncestry = 0;  // see TrackInformation
+    G4double fWeight = 1.;  // track weight
+    const G4Material* fMaterial = nullptr;  // material the energy was deposited in
+    G4double fEdep = 0.;
+    G4double fStepLength = 0.;
+    G4double fPreKineticEnergy = 0.;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+using ScoringHitsCollection = G4THitsCollection<ScoringHit>;
+
+extern G4ThreadLocal G4Allocator<ScoringHit>* ScoringHitAllocator;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline void* ScoringHit::operator new(size_t)
+{
+  if (!ScoringHitAllocator) ScoringHitAllocator = new G4Allocator<ScoringHit>;
+  return (void*)ScoringHitAllocator->MallocSingle();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline void ScoringHit::operator delete(void* hit)
+{
+  ScoringHitAllocator->FreeSingle((ScoringHit*)hit);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
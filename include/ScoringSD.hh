@@ -0,0 +1,88 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ScoringSD.hh
+/// \brief Definition of the ScoringSD class
+//
+// Sensitive detector of one scoring volume. The silicon slabs keep the steps
+// which deposit energy, the boron converter keeps every step. The silicon
+// slabs also merge the consecutive steps of a track into ScoringSegments,
+// closed when the track leaves the slab or stops. The segments are only
+// built when they are saved (/stepping/saveSiliconSegments). The hits are written to
+// the ntuples by EventAction at end of event.
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef ScoringSD_h
+#define ScoringSD_h 1
+
+#include "DetectorConstruction.hh"
+#include "ScoringHit.hh"
+#include "ScoringSegment.hh"
+
+#include "G4VSensitiveDetector.hh"
+
+class G4HCofThisEvent;
+class G4Step;
+class G4TouchableHistory;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class ScoringSD : public G4VSensitiveDetector
+{
+  public:
+    explicit ScoringSD(ScoringVolume);
+    ~ScoringSD() override = default;
+
+    void Initialize(G4HCofThisEvent*) override;
+    G4bool ProcessHits(G4Step*, G4TouchableHistory*) override;
+
+  public:
+    enum Collection
+    {
+      kStepHits = 0,
+      kSegments  // silicon slabs only
+    };
+
+    // Detector and hits collection names, "<detector>/<collection>"
+    static const G4String& GetDetectorName(ScoringVolume);
+    static G4String GetCollectionName(ScoringVolume, Collection = kStepHits);
+
+    // The segments are only built when they are written, for the calling thread
+    static void SetSaveSegments(G4bool);
+
+  private:
+    void AddToSegment(const G4Step*);
+
+    ScoringVolume fVolume = kNotScored;
+    ScoringHitsCollection* fHitsCollection = nullptr;
+    ScoringSegmentsCollection* fSegmentsCollection = nullptr;
+    ScoringSegment* fOpenSegment = nullptr;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
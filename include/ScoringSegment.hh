@@ -0,0 +1,123 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ScoringSegment.hh
+/// \brief Definition of the ScoringSegment class
+//
+// One passage of a track through a silicon slab, accumulated by ScoringSD
+// from the consecutive steps of the track in the slab: entry and exit point,
+// summed energy deposit and track length, maximum step dE/dx. A track which
+// leaves and re-enters the slab gives a new segment.
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef ScoringSegment_h
+#define ScoringSegment_h 1
+
+#include "G4Allocator.hh"
+#include "G4THitsCollection.hh"
+#include "G4ThreeVector.hh"
+#include "G4VHit.hh"
+#include "globals.hh"
+
+class G4LogicalVolume;
+class G4ParticleDefinition;
+class G4Step;
+class G4VProcess;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class ScoringSegment : public G4VHit
+{
+  public:
+    ScoringSegment() = default;
+    explicit ScoringSegment(const G4Step*);  // opens the segment at the pre-step point
+    ~ScoringSegment() override = default;
+
+    inline void* operator new(size_t);
+    inline void operator delete(void*);
+
+    // Adds a step of the same track
+    void AddStep(const G4Step*);
+
+  public:
+    const G4ParticleDefinition* GetParticle() const { return fParticle; };
+    G4int GetParentID() const { return fParentID; };
+    G4int GetTrackID() const { return fTrackID; };
+    const G4ThreeVector& GetEntryPosition() const { return fEntryPosition; };
+    const G4ThreeVector& GetExitPosition() const { return fExitPosition; };
+    G4double GetEntryKineticEnergy() const { return fEntryKineticEnergy; };
+    const G4VProcess* GetCreatorProcess() const { return fCreatorProcess; };
+    const G4LogicalVolume* GetVertexVolume() const { return fVertexVolume; };
+    G4int GetAncestry() const { return fAncestry; };
+    G4double GetWeight() const { return fWeight; };
+    G4double GetEdep() const { return fEdep; };
+    G4double GetTrackLength() const { return fTrackLength; };
+    G4double GetMeanDEDX() const { return (fTrackLength > 0.) ? fEdep / fTrackLength : 0.; };
+    G4double GetMaxDEDX() const { return fMaxDEDX; };
+    G4int GetNbOfSteps() const { return fNbOfSteps; };
+
+  private:
+    const G4ParticleDefinition* fParticle = nullptr;
+    G4int fParentID = 0;
+    G4int fTrackID = 0;
+    G4ThreeVector fEntryPosition;
+    G4ThreeVector fExitPosition;
+    G4double fEntryKineticEnergy = 0.;
+    const G4VProcess* fCreatorProcess = nullptr;
+    const G4LogicalVolume* fVertexVolume = nullptr;
+    G4int fAncestry = 0;  // see TrackInformation
+    G4double fWeight = 1.;  // track weight at the entry
+    G4double fEdep = 0.;
+    G4double fTrackLength = 0.;
+    G4double fMaxDEDX = 0.;
+    G4int fNbOfSteps = 0;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+using ScoringSegmentsCollection = G4THitsCollection<ScoringSegment>;
+
+extern G4ThreadLocal G4Allocator<ScoringSegment>* ScoringSegmentAllocator;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline void* ScoringSegment::operator new(size_t)
+{
+  if (!ScoringSegmentAllocator) ScoringSegmentAllocator = new G4Allocator<ScoringSegment>;
+  return (void*)ScoringSegmentAllocator->MallocSingle();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline void ScoringSegment::operator delete(void* segment)
+{
+  ScoringSegmentAllocator->FreeSingle((ScoringSegment*)segment);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
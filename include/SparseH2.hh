@@ -0,0 +1,93 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file SparseH2.hh
+/// \brief Definition of the SparseH2 class
+//
+// 2D histogram storing only the bins which were filled, for the fluence
+// maps on the world faces: with a collimated beam most of their bins stay
+// empty, and a dense map of every particle category and face on every
+// thread costs memory and merge time for nothing. Entries outside the
+// axes are counted but not stored.
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef SparseH2_h
+#define SparseH2_h 1
+
+#include "globals.hh"
+
+#include <cstdint>
+#include <iosfwd>
+#include <unordered_map>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class SparseH2
+{
+  public:
+    struct Bin
+    {
+        G4double fSumW = 0.;
+        G4double fSumW2 = 0.;
+    };
+
+  public:
+    SparseH2() = default;
+    SparseH2(G4int nbinsX, G4double xmin, G4double xmax, G4int nbinsY, G4double ymin,
+             G4double ymax);
+
+    void Fill(G4double x, G4double y, G4double weight = 1.);
+    // Adds a histogram with the same axes
+    void Merge(const SparseH2&);
+    void Reset();
+    // Axes and filled bins, for the checkpoints
+    void Save(std::ostream&) const;
+    G4bool Restore(std::istream&);
+
+    G4int GetNbinsX() const { return fNbinsX; };
+    G4int GetNbinsY() const { return fNbinsY; };
+    // Centre of the bin ix, iy (0 to nbins-1)
+    G4double GetBinCenterX(G4int ix) const { return fXmin + (ix + 0.5) / fInvWidthX; };
+    G4double GetBinCenterY(G4int iy) const { return fYmin + (iy + 0.5) / fInvWidthY; };
+    G4double GetOutOfRange() const { return fOutOfRange; };
+
+    // Filled bins, keyed by ix + nbinsX * iy
+    const std::unordered_map<std::uint32_t, Bin>& GetBins() const { return fBins; };
+    G4int GetBinX(std::uint32_t key) const { return G4int(key % fNbinsX); };
+    G4int GetBinY(std::uint32_t key) const { return G4int(key / fNbinsX); };
+
+  private:
+    G4int fNbinsX = 1, fNbinsY = 1;
+    G4double fXmin = 0., fYmin = 0.;
+    G4double fInvWidthX = 1., fInvWidthY = 1.;
+    G4double fOutOfRange = 0.;
+    std::unordered_map<std::uint32_t, Bin> fBins;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
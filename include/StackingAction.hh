@@ -0,0 +1,93 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file StackingAction.hh
+/// \brief Definition of the StackingAction class
+//
+// Kills or defers new tracks which cannot contribute to the scored
+// quantities. Each rule is a StepFilter expression evaluated on the new
+// track (particle, creation volume or region, creator process, initial
+// kinetic energy) with the classification it gets, e.g.
+//   /stacking/kill particle == anti_nu_e || particle == nu_e
+//   /stacking/kill particle == e- && energy < 1 keV && volume == World
+// The first matching rule applies, the primaries are never touched. Without
+// rules every track is tracked as before.
+//
+// The number and kinetic energy of the tracks taken by each rule are
+// counted in Run and printed at the end of the run. Rules get an id from a
+// registry shared by all threads so that the worker counts can be merged.
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef StackingAction_h
+#define StackingAction_h 1
+
+#include "StepFilter.hh"
+
+#include "G4UserStackingAction.hh"
+#include "globals.hh"
+
+#include <vector>
+
+class StackingActionMessenger;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class StackingAction : public G4UserStackingAction
+{
+  public:
+    StackingAction();
+    ~StackingAction() override;
+
+    G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track*) override;
+    void PrepareNewEvent() override;
+
+    // classification: fKill or fWaiting
+    void AddRule(G4ClassificationOfNewTrack classification, const G4String& expression);
+    void ClearRules();
+    void ListRules() const;
+
+    // Shared registry: description of a rule id ("kill <expression>")
+    static G4String GetRuleName(G4int id);
+
+  private:
+    struct Rule
+    {
+        G4int fId = -1;
+        G4ClassificationOfNewTrack fClassification = fUrgent;
+        StepFilter fFilter;
+    };
+
+    static G4int Register(const G4String& name);
+
+    std::vector<Rule> fRules;
+    G4int fFilterRunID = -1;
+    StackingActionMessenger* fStackingMessenger = nullptr;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
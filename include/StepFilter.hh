@@ -0,0 +1,149 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file StepFilter.hh
+/// \brief Definition of the StepFilter class
+//
+// Selection of the steps to record, written as an expression in a macro,
+// e.g.
+//   particle == neutron && process == neutronInelastic
+//   volume == B4C_enriched && (energy < 1 eV || edep > 10 keV)
+//
+// Fields:     particle, volume (pre-step logical volume), region (region of
+//             that volume), process (process which limited the step),
+//             energy (pre-step kinetic energy), edep (energy deposit of the
+//             step)
+// Operators:  == != for names, == != < <= > >= for energies (default unit
+//             MeV), && || ! and parentheses, "all" accepts every step.
+//
+// The same expressions select new tracks (StackingAction): volume is then
+// the volume the track was created in, process its creator process, energy
+// its initial kinetic energy, and edep is 0.
+//
+// The expression is parsed once into a tree of nodes. Names are turned into
+// pointers or process codes at the start of each run so that evaluating a
+// step compares pointers and numbers only. A comparison with a name that
+// matches no particle or process is always false.
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef StepFilter_h
+#define StepFilter_h 1
+
+#include "globals.hh"
+
+#include <memory>
+#include <vector>
+
+class G4LogicalVolume;
+class G4ParticleDefinition;
+class G4Region;
+class G4Step;
+class G4Track;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class StepFilter
+{
+  public:
+    StepFilter() = default;
+    explicit StepFilter(const G4String& expression);
+    ~StepFilter() = default;
+    StepFilter(StepFilter&&) = default;
+    StepFilter& operator=(StepFilter&&) = default;
+
+  public:
+    // Replaces the filter, returns false and keeps the previous one if the
+    // expression cannot be parsed
+    G4bool Compile(const G4String& expression, G4String& error);
+
+    // Resolves the volume and region names, to be called once the geometry is built
+    // and whenever it may have changed (start of run)
+    void Prepare();
+
+    G4bool Accept(const G4Step* step, G4int processCode)
+    {
+      return (fRoot == nullptr) || Evaluate(*fRoot, step, processCode);
+    };
+    // New track, before it is stacked
+    G4bool Accept(const G4Track* track)
+    {
+      return (fRoot == nullptr) || Evaluate(*fRoot, track);
+    };
+
+    const G4String& GetExpression() const { return fExpression; };
+
+  public:
+    enum NodeType
+    {
+      kAnd,
+      kOr,
+      kNot,
+      kTrue,
+      kParticle,
+      kVolume,
+      kRegion,
+      kProcess,
+      kEnergy,
+      kEdep
+    };
+
+    enum Comparison
+    {
+      kEqual,
+      kNotEqual,
+      kLess,
+      kLessEqual,
+      kGreater,
+      kGreaterEqual
+    };
+
+    struct Node
+    {
+        NodeType fType = kTrue;
+        Comparison fComparison = kEqual;
+        std::unique_ptr<Node> fLeft, fRight;
+
+        G4String fName;  // particle, volume and region names
+        const G4ParticleDefinition* fParticle = nullptr;  // null if unknown
+        std::vector<const G4LogicalVolume*> fVolumes;  // all volumes of this name
+        const G4Region* fRegion = nullptr;
+        G4int fProcessCode = -1;  // -1 if unknown
+        G4double fValue = 0.;
+    };
+
+  private:
+    G4bool Evaluate(Node&, const G4Step*, G4int processCode);
+    G4bool Evaluate(Node&, const G4Track*);
+    void Prepare(Node&);
+
+    std::unique_ptr<Node> fRoot;  // null accepts every step
+    G4String fExpression = "all";
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
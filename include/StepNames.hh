@@ -0,0 +1,75 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file StepNames.hh
+/// \brief Definition of the StepNames helpers
+//
+// Name resolution for the ntuple string columns. The recorders keep only
+// pointers while a step is processed and call these once a row is written.
+// All of them return references to strings owned by Geant4 or to constants
+// of this module, so nothing is copied before the analysis manager takes
+// the value.
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef StepNames_h
+#define StepNames_h 1
+
+#include "globals.hh"
+
+class G4Isotope;
+class G4Step;
+class G4Track;
+class G4VPhysicalVolume;
+class G4VProcess;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace StepNames
+{
+// Volume name, "Out_of_World" past the world boundary
+const G4String& Volume(const G4VPhysicalVolume* pv);
+
+// Creator process name, "NoCreator" for primaries
+const G4String& Creator(G4int parentID, const G4VProcess* creator);
+const G4String& Creator(const G4Track* track);
+
+// Process name, "No PostProcess" if the step was not limited by a process
+const G4String& Process(const G4VProcess* process);
+
+// Target isotope of the hadronic interaction ending the step, if any. Only
+// valid while the step is processed: the process reuses it for the next
+// interaction.
+const G4Isotope* TargetIsotope(const G4Step* step);
+
+// Target isotope name, or the post-step volume name if there is none
+const G4String& Target(const G4Isotope* target, const G4VPhysicalVolume* postPV);
+const G4String& Target(const G4Step* step);
+}  // namespace StepNames
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,133 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file StepProfile.hh
+/// \brief Definition of the StepProfile class
+//
+// Builds with NEUTRONSOURCE_PROFILE_STEPPING (cmake -DNEUTRONSOURCE_PROFILE_STEPPING=ON)
+// time the sections of the stepping, sensitive detector and end of event code
+// with the CPU time stamp counter. Each section counts how often it is entered,
+// which for the sections inside an if is how often the branch is taken, and
+// the ticks spent in it. The counts live in the Run of each thread, are merged
+// in Run::Merge and printed as a cost table at the end of the run.
+//
+// In other builds PROFILE_STEP_SECTION expands to nothing.
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef StepProfile_h
+#define StepProfile_h 1
+
+#include "globals.hh"
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#  include <x86intrin.h>
+#endif
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class StepProfile
+{
+  public:
+    // Sections are nested: kStep contains the other stepping sections, and
+    // kWriteHits contains kStoppingPower
+    enum Section
+    {
+      kStep,  // SteppingAction::RecordStep
+      kCountProcesses,
+      kTagSecondaries,
+      kTrackSummary,
+      kFilters,
+      kNeutronCapture,
+      kExitWorld,
+      kPrintStep,
+      kScoringSD,  // ScoringSD::ProcessHits
+      kTriggers,  // EventAction::EndOfEventAction
+      kWriteStaged,
+      kWriteHits,
+      kStoppingPower,
+      kWriteSegments,
+      kNbSections
+    };
+
+#ifdef NEUTRONSOURCE_PROFILE_STEPPING
+    // Adds the ticks spent between construction and destruction to a section
+    class Timer
+    {
+      public:
+        explicit Timer(Section section)
+          : fProfile(Current()), fSection(section), fStart(Ticks())
+        {}
+        ~Timer() { fProfile.Add(fSection, Ticks() - fStart); }
+
+      private:
+        StepProfile& fProfile;
+        Section fSection;
+        std::uint64_t fStart;
+    };
+
+    // Profile of the run being processed by the calling thread
+    static StepProfile& Current();
+#endif
+
+    void Add(Section section, std::uint64_t ticks)
+    {
+      ++fCalls[section];
+      fTicks[section] += ticks;
+    };
+
+    void Merge(const StepProfile&);
+    void Print() const;
+
+    static std::uint64_t Ticks()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+      return __rdtsc();
+#else
+      return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+    };
+
+  private:
+    std::uint64_t fCalls[kNbSections] = {};
+    std::uint64_t fTicks[kNbSections] = {};
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifdef NEUTRONSOURCE_PROFILE_STEPPING
+#  define PROFILE_STEP_SECTION(section) \
+    StepProfile::Timer stepProfileTimer_##section(StepProfile::section)
+#else
+#  define PROFILE_STEP_SECTION(section)
+#endif
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -33,28 +33,56 @@
 #ifndef SteppingAction_h
 #define SteppingAction_h 1
 
+#include "StepFilter.hh"
+
 #include "G4UserSteppingAction.hh"
 #include "globals.hh"
 
+#include <vector>
+
+class DetectorConstruction;
 class EventAction;
 class SteppingActionMessenger;
+class G4Track;
+struct ProcessInfo;
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 class SteppingAction : public G4UserSteppingAction {
 public:
-  SteppingAction(EventAction *);
+  SteppingAction(DetectorConstruction *, EventAction *);
   ~SteppingAction() override;
 
   void UserSteppingAction(const G4Step *) override;
   void SaveSiliconEdepData(G4int);
+  void SaveSiliconSegmentData(G4int);
   void SaveParticleFluxData(G4int);
+  void SaveTrackSummaryData(G4int);
+  void SetDedxCheckTolerance(G4double);
+  void SetCaptureTrigger(G4int);
+  void SetEdepTrigger(const G4String &, G4double);
+  void ClearTriggers();
+  // ntupleName: neutronCapture or exitWorld
+  void SetRecordingFilter(const G4String &ntupleName, const G4String &);
+  void ListRecordingFilters();
 
 private:
+  // Stages the rows for this step, returns false if nothing was recorded
+  G4bool RecordStep(const G4Step *);
+  // Attaches a TrackInformation to the secondaries created in the step
+  void TagSecondaries(const G4Step *, const ProcessInfo &,
+                      const std::vector<const G4Track *> &);
+
+  DetectorConstruction *fDetector = nullptr;
   EventAction *fEventAction = nullptr;
-  G4int save_silicon_data = 0;
   G4int save_flux_data = 0;
   G4int print_step_info = 0;
   SteppingActionMessenger *steppingMessenger = nullptr;
+
+  // Selection of the steps written to NeutronCapture_Data and
+  // Particles_Exit_World, see /stepping/filter/
+  StepFilter fNeutronCaptureFilter;
+  StepFilter fExitWorldFilter;
+  G4int fFilterRunID = -1;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
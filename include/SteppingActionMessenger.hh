@@ -49,6 +49,8 @@ class SteppingAction;
 class G4UIdirectory;
 class G4UIcmdWithAString;
 class G4UIcmdWithAnInteger;
+class G4UIcmdWithADouble;
+class G4UIcmdWithoutParameter;
 class G4UIcommand;
 
 
@@ -67,7 +69,17 @@ class SteppingActionMessenger: public G4UImessenger {
     // G4UIcmdWithAString*   colourNeutronCmd;
       G4UIdirectory *fSteppingDir = nullptr;
       G4UIcmdWithAnInteger *SaveSiliconData = nullptr;
+      G4UIcmdWithAnInteger *SaveSiliconSegments = nullptr;
       G4UIcmdWithAnInteger *SaveFluxData = nullptr;
+      G4UIcmdWithAnInteger *SaveTrackSummary = nullptr;
+      G4UIcmdWithADouble *DedxCheckTolerance = nullptr;
+      G4UIcmdWithAnInteger *TriggerOnCapture = nullptr;
+      G4UIcommand *TriggerEdep = nullptr;
+      G4UIcmdWithoutParameter *ClearTriggers = nullptr;
+      G4UIdirectory *fFilterDir = nullptr;
+      G4UIcmdWithAString *FilterNeutronCapture = nullptr;
+      G4UIcmdWithAString *FilterExitWorld = nullptr;
+      G4UIcmdWithoutParameter *ListFilters = nullptr;
 
 
 };
@@ -0,0 +1,94 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file StoppingPowerCache.hh
+/// \brief Definition of the StoppingPowerCache class
+//
+// Restricted (G4EmCalculator::GetDEDX) and total
+// (G4EmCalculator::ComputeTotalDEDX) stopping powers, tabulated per
+// (particle, material) on a log-spaced kinetic energy grid the first time
+// the pair is asked for, then interpolated. Energies outside the grid fall
+// back to the calculator. Each worker owns its own cache (EventAction).
+//
+// With a positive check tolerance every lookup is also computed exactly and
+// relative deviations above the tolerance are reported.
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef StoppingPowerCache_h
+#define StoppingPowerCache_h 1
+
+#include "G4EmCalculator.hh"
+#include "globals.hh"
+
+#include <map>
+#include <utility>
+#include <vector>
+
+class G4Material;
+class G4ParticleDefinition;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class StoppingPowerCache
+{
+  public:
+    StoppingPowerCache() = default;
+    ~StoppingPowerCache() = default;
+
+  public:
+    // Restricted and total dE/dx at the given kinetic energy
+    void GetDEDX(G4double ekin, const G4ParticleDefinition*, const G4Material*,
+                 G4double& restricted, G4double& total);
+
+    // Drop the tables, e.g. when the production cuts may have changed
+    void Clear() { fTables.clear(); };
+
+    // Relative tolerance of the accuracy check, 0 disables it
+    void SetCheckTolerance(G4double val) { fCheckTolerance = val; };
+    G4double GetCheckTolerance() const { return fCheckTolerance; };
+
+  private:
+    struct Table
+    {
+        std::vector<G4double> fRestricted;
+        std::vector<G4double> fTotal;
+    };
+
+    const Table& GetTable(const G4ParticleDefinition*, const G4Material*);
+    void Check(G4double ekin, const G4ParticleDefinition*, const G4Material*,
+               G4double restricted, G4double total);
+
+    G4EmCalculator fCalculator;
+    std::map<std::pair<const G4ParticleDefinition*, const G4Material*>, Table> fTables;
+
+    G4double fCheckTolerance = 0.;
+    G4int fNbCheckWarnings = 0;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,117 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file TrackInformation.hh
+/// \brief Definition of the TrackInformation class
+//
+// Ancestry of a track as a set of bit flags, attached by SteppingAction to
+// every secondary in the step which creates it. The flags of the parent are
+// inherited, so a track knows whether any of its ancestors came from a 10B
+// capture, a neutron or a photon. The rows written to the ntuples carry the
+// integer (fAncestry column); primaries have no information and write 0.
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef TrackInformation_h
+#define TrackInformation_h 1
+
+#include "G4Allocator.hh"
+#include "G4Track.hh"
+#include "G4VUserTrackInformation.hh"
+#include "globals.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class TrackInformation : public G4VUserTrackInformation
+{
+  public:
+    // Bits 0-7 are flags, bits 8-11 the slab of the primary neutron
+    // interaction (see GetLayer)
+    enum Ancestry : G4int
+    {
+      kFromB10Capture = 1 << 0,  // an ancestor comes from a neutron absorbed by 10B
+      kFromNeutron = 1 << 1,  // an ancestor was created by a neutron
+      kFromPrimaryNeutron = 1 << 2,  // an ancestor was created by the primary neutron
+      kFromPhoton = 1 << 3,  // an ancestor is a photon
+      kCreatedByPhoton = 1 << 4,  // the parent is a photon (compt, phot, conv, ...)
+      kFromRadioactiveDecay = 1 << 5  // an ancestor comes from a radioactive decay
+    };
+    static constexpr G4int kLayerShift = 8;
+    static constexpr G4int kLayerMask = 0xF << kLayerShift;
+
+  public:
+    explicit TrackInformation(G4int ancestry) : fAncestry(ancestry) {}
+    ~TrackInformation() override = default;
+
+    inline void* operator new(size_t);
+    inline void operator delete(void*);
+
+    void Print() const override;
+
+    G4int GetAncestry() const { return fAncestry; };
+
+    // Ancestry of a track, 0 for the primaries
+    static G4int GetAncestry(const G4Track* track)
+    {
+      auto info = static_cast<const TrackInformation*>(track->GetUserInformation());
+      return (info != nullptr) ? info->fAncestry : 0;
+    };
+
+    // Flags of a secondary created by the parent in this step. layer is the
+    // slab the step happened in (-1 outside the slabs), isB10Capture tells if
+    // the step is a neutron absorbed by 10B.
+    static G4int SecondaryAncestry(const G4Track* parent, G4int layer, G4bool isB10Capture,
+                                   G4bool isRadioactiveDecay);
+
+    // Slab of the primary neutron interaction the track descends from, -1 if none
+    static G4int GetLayer(G4int ancestry) { return ((ancestry & kLayerMask) >> kLayerShift) - 1; };
+
+  private:
+    G4int fAncestry = 0;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+extern G4ThreadLocal G4Allocator<TrackInformation>* TrackInformationAllocator;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline void* TrackInformation::operator new(size_t)
+{
+  if (!TrackInformationAllocator) TrackInformationAllocator = new G4Allocator<TrackInformation>;
+  return (void*)TrackInformationAllocator->MallocSingle();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline void TrackInformation::operator delete(void* info)
+{
+  TrackInformationAllocator->FreeSingle((TrackInformation*)info);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -33,23 +33,41 @@
 #ifndef TrackingAction_h
 #define TrackingAction_h 1
 
+#include "G4ThreeVector.hh"
 #include "G4UserTrackingAction.hh"
 #include "globals.hh"
 
+class DetectorConstruction;
 class EventAction;
+struct TrackSummaryRow;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 class TrackingAction : public G4UserTrackingAction
 {
   public:
-    TrackingAction(EventAction*);
+    TrackingAction(DetectorConstruction*, EventAction*);
     ~TrackingAction() override = default;
 
     void PreUserTrackingAction(const G4Track*) override;
     void PostUserTrackingAction(const G4Track*) override;
 
   private:
+    // World face a track leaves through, in the order of the flux H2
+    enum Face : G4int
+    {
+      kMinusZ,
+      kPlusZ,
+      kMinusX,
+      kPlusX,
+      kMinusY,
+      kPlusY,
+      kNbFaces
+    };
+    Face GetExitFace(const G4ThreeVector& position);
+    void EndTrackSummary(const G4Track*, TrackSummaryRow&);
+
+    DetectorConstruction* fDetector = nullptr;
     EventAction* fEventAction = nullptr;
 };
 
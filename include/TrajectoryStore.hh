@@ -0,0 +1,127 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file TrajectoryStore.hh
+/// \brief Definition of the TrajectoryStore class
+//
+// Light trajectories for debugging production runs, without the cost of
+// /tracking/storeTrajectory. The points of a track are kept as floats (mm,
+// MeV), one every `stride` steps plus the first and the last one. The
+// tracks of the last N events, or of the last N events passing the event
+// triggers, are kept in a ring buffer of the thread. The buffer is printed
+// on demand, or when an event is flagged (it passes the triggers or is
+// marked to be kept).
+//
+// Commands (/stepping/trajectory/):
+//   keepEvents N     size of the ring buffer, 0 (default) turns it off
+//   stride k         keep one step point out of k
+//   triggeredOnly b  keep only the events passing the triggers
+//   dumpOnFlag b     print the buffer when an event is flagged
+//   dump             print the buffer (in MT, at the start of the next run)
+//
+// The event buffers are swapped in and out of the ring, so once the ring
+// is full the vectors keep their capacity and nothing is allocated.
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef TrajectoryStore_h
+#define TrajectoryStore_h 1
+
+#include "globals.hh"
+
+#include <cstdint>
+#include <vector>
+
+class G4Event;
+class G4GenericMessenger;
+class G4ParticleDefinition;
+class G4Step;
+class G4Track;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class TrajectoryStore
+{
+  public:
+    struct Point
+    {
+        G4float fX = 0.f, fY = 0.f, fZ = 0.f;  // mm
+        G4float fKinEnergy = 0.f;  // MeV
+    };
+
+    struct Trajectory
+    {
+        G4int fTrackID = 0;
+        G4int fParentID = 0;
+        const G4ParticleDefinition* fParticle = nullptr;
+        std::uint32_t fFirstPoint = 0;  // index in EventTrajectories::fPoints
+        std::uint32_t fNbPoints = 0;
+    };
+
+    struct EventTrajectories
+    {
+        G4int fEventID = -1;
+        std::vector<Trajectory> fTrajectories;
+        std::vector<Point> fPoints;
+    };
+
+  public:
+    TrajectoryStore();
+    ~TrajectoryStore();
+
+    G4bool IsActive() const { return !fRing.empty(); };
+
+    // Called by the user actions while the event is processed
+    void BeginOfEvent(const G4Event*);
+    void StartTrack(const G4Track*);
+    void AddStep(const G4Step*);
+    void EndTrack(const G4Track*);
+    // fired: one of the /stepping/ triggers fired for this event
+    void EndOfEvent(const G4Event*, G4bool fired);
+
+    void SetNbEvents(G4int);
+    void SetStride(G4int);
+    void Dump();
+
+  private:
+    void DefineCommands();
+    void AddPoint(const G4Track*);
+
+    std::vector<EventTrajectories> fRing;
+    std::size_t fNext = 0;  // slot the next kept event goes to
+    std::size_t fNbKept = 0;
+    EventTrajectories fCurrent;
+    G4int fStepsSincePoint = 0;
+
+    G4int fStride = 10;
+    G4bool fTriggeredOnly = false;
+    G4bool fDumpOnFlag = false;
+    G4GenericMessenger* fMessenger = nullptr;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -32,6 +32,7 @@
 #include "EventAction.hh"
 #include "PrimaryGeneratorAction.hh"
 #include "RunAction.hh"
+#include "StackingAction.hh"
 #include "SteppingAction.hh"
 #include "TrackingAction.hh"
 
@@ -60,11 +61,14 @@ void ActionInitialization::Build() const
   EventAction* event = new EventAction();
   SetUserAction(event);
 
-  TrackingAction* trackingAction = new TrackingAction(event);
+  TrackingAction* trackingAction = new TrackingAction(fDetector, event);
   SetUserAction(trackingAction);
 
-  SteppingAction* steppingAction = new SteppingAction(event);
+  SteppingAction* steppingAction = new SteppingAction(fDetector, event);
   SetUserAction(steppingAction);
+
+  StackingAction* stackingAction = new StackingAction();
+  SetUserAction(stackingAction);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
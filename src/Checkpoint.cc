@@ -0,0 +1,254 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file Checkpoint.cc
+/// \brief Implementation of the Checkpoint class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "Checkpoint.hh"
+
+#include "HistoManager.hh"
+#include "Run.hh"
+
+#include "G4AnalysisManager.hh"
+#include "G4Threading.hh"
+#include "Randomize.hh"
+
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+namespace
+{
+const char* kMagic = "NeutronSource_checkpoint";
+const G4int kVersion = 1;
+
+// Only touched by the thread which processes the events, in sequential mode
+G4int checkpointInterval = 0;
+G4String checkpointFileName = "NeutronSource.ckpt";
+G4String baseFileName;  // analysis file name at the start of the run
+G4int chunk = 0;  // <baseFileName>_<chunk> is the open analysis file, 0 for the first one
+G4bool resumePending = false;
+G4String resumeFileName;
+G4int eventOffset = 0;
+
+G4String ChunkName(G4int k)
+{
+  return (k == 0) ? baseFileName : baseFileName + "_" + std::to_string(k);
+}
+
+// Header of a checkpoint: events processed and to process, analysis file
+G4bool ReadHeader(std::istream& is, G4int& nbOfEvents, G4int& nbOfEventsToProcess,
+                  G4String& fileName, G4int& fileChunk)
+{
+  G4String magic, label1, label2;
+  G4int version = 0;
+  is >> magic >> version >> label1 >> nbOfEvents >> nbOfEventsToProcess >> label2 >> fileName
+    >> fileChunk;
+  return !is.fail() && magic == kMagic && version == kVersion && label1 == "events"
+         && label2 == "file";
+}
+
+G4bool ExpectLabel(std::istream& is, const char* label)
+{
+  G4String word;
+  return (is >> word) && word == label;
+}
+
+// Writes the ntuples of a chunk. The histograms hold the whole run so far,
+// they are kept out of the chunk (inactive objects are not written) and
+// only go to the last file
+void WriteNtuples(G4AnalysisManager* analysisManager)
+{
+  const G4int nbH1 = analysisManager->GetNofH1s();
+  const G4int nbH2 = analysisManager->GetNofH2s();
+  std::vector<G4bool> h1Active(nbH1), h2Active(nbH2);
+  for (G4int ih = 0; ih < nbH1; ih++) {
+    h1Active[ih] = analysisManager->GetH1Activation(ih);
+    analysisManager->SetH1Activation(ih, false);
+  }
+  for (G4int ih = 0; ih < nbH2; ih++) {
+    h2Active[ih] = analysisManager->GetH2Activation(ih);
+    analysisManager->SetH2Activation(ih, false);
+  }
+  analysisManager->Write();
+  for (G4int ih = 0; ih < nbH1; ih++) {
+    analysisManager->SetH1Activation(ih, h1Active[ih]);
+  }
+  for (G4int ih = 0; ih < nbH2; ih++) {
+    analysisManager->SetH2Activation(ih, h2Active[ih]);
+  }
+}
+}  // namespace
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Checkpoint::SetInterval(G4int nbOfEvents)
+{
+  if (nbOfEvents > 0 && G4Threading::IsMultithreadedApplication()) {
+    G4cout << "\n --->warning from Checkpoint : checkpoints are only taken in sequential mode"
+           << G4endl;
+    return;
+  }
+  checkpointInterval = nbOfEvents;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Checkpoint::SetFileName(const G4String& name)
+{
+  checkpointFileName = name;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool Checkpoint::Resume(const G4String& fileName, G4int& nbOfEventsLeft)
+{
+  if (G4Threading::IsMultithreadedApplication()) {
+    G4cout << "\n --->warning from Checkpoint : a run can only be resumed in sequential mode"
+           << G4endl;
+    return false;
+  }
+
+  std::ifstream is(fileName);
+  G4int nbOfEvents = 0, nbOfEventsToProcess = 0, fileChunk = 0;
+  G4String analysisFileName;
+  if (!ReadHeader(is, nbOfEvents, nbOfEventsToProcess, analysisFileName, fileChunk)) {
+    G4cout << "\n --->warning from Checkpoint : " << fileName << " is not a checkpoint"
+           << G4endl;
+    return false;
+  }
+
+  resumePending = true;
+  resumeFileName = fileName;
+  eventOffset = nbOfEvents;
+  baseFileName = analysisFileName;
+  chunk = fileChunk;
+  nbOfEventsLeft = nbOfEventsToProcess - nbOfEvents;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool Checkpoint::BeginOfRun(Run* run, HistoManager* histoManager)
+{
+  G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
+  if (!resumePending) {
+    baseFileName = analysisManager->GetFileName();
+    chunk = 0;
+    eventOffset = 0;
+    return true;
+  }
+  resumePending = false;
+
+  std::ifstream is(resumeFileName);
+  G4int nbOfEvents = 0, nbOfEventsToProcess = 0, fileChunk = 0;
+  G4String analysisFileName;
+  G4bool restored = ReadHeader(is, nbOfEvents, nbOfEventsToProcess, analysisFileName, fileChunk)
+                    && ExpectLabel(is, "random");
+  if (restored) {
+    G4Random::restoreFullState(is);
+    restored = ExpectLabel(is, "run") && run->Restore(is, nbOfEvents)
+               && ExpectLabel(is, "histograms") && histoManager->RestoreHistograms(is)
+               && ExpectLabel(is, "end");
+  }
+  if (!restored) {
+    G4cout << "\n --->warning from Checkpoint : " << resumeFileName
+           << " cannot be restored (histogram bookings differ?)" << G4endl;
+    eventOffset = 0;
+    return false;
+  }
+
+  // the rows of the events after the checkpoint go to the chunk it opened
+  analysisManager->SetFileName(ChunkName(chunk));
+  G4cout << "\n Run resumed from " << resumeFileName << " after " << nbOfEvents << " events"
+         << G4endl;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Checkpoint::EndOfRun()
+{
+  // the next run starts again from the file name it was given
+  if (chunk > 0) G4AnalysisManager::Instance()->SetFileName(baseFileName);
+  chunk = 0;
+  eventOffset = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Checkpoint::EndOfEvent(const Run* run)
+{
+  if (checkpointInterval <= 0) return;
+
+  // the event is added to the run after the end of event action
+  const G4int nbOfEvents = run->GetNumberOfEvent() + 1;
+  const G4int nbOfEventsToProcess = eventOffset + run->GetNumberOfEventToBeProcessed();
+  if (nbOfEvents % checkpointInterval != 0 || nbOfEvents >= nbOfEventsToProcess) return;
+
+  // close the ntuple chunk, the histograms are not reset
+  G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
+  if (analysisManager->IsActive()) {
+    WriteNtuples(analysisManager);
+    analysisManager->CloseFile(false);
+    analysisManager->OpenFile(ChunkName(++chunk));
+  }
+
+  // written aside then renamed, a crash while writing keeps the previous one
+  const G4String tmpName = checkpointFileName + ".tmp";
+  {
+    std::ofstream os(tmpName);
+    os.precision(std::numeric_limits<G4double>::max_digits10);
+    os << kMagic << ' ' << kVersion << '\n'
+       << "events " << nbOfEvents << ' ' << nbOfEventsToProcess << '\n'
+       << "file " << baseFileName << ' ' << chunk << '\n'
+       << "random\n";
+    G4Random::saveFullState(os);
+    os << "\nrun\n";
+    run->Save(os);
+    os << "histograms\n";
+    HistoManager::Instance()->SaveHistograms(os);
+    os << "end\n";
+    if (!os) {
+      G4cout << "\n --->warning from Checkpoint : cannot write " << tmpName << G4endl;
+      return;
+    }
+  }
+  std::rename(tmpName.c_str(), checkpointFileName.c_str());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int Checkpoint::GetEventOffset()
+{
+  return eventOffset;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
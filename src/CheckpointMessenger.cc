@@ -0,0 +1,103 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file CheckpointMessenger.cc
+/// \brief Implementation of the CheckpointMessenger class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "CheckpointMessenger.hh"
+
+#include "Checkpoint.hh"
+
+#include "G4RunManager.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIdirectory.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+CheckpointMessenger::CheckpointMessenger()
+{
+  // The checkpoints are taken in sequential mode only, nothing is broadcast
+  fCheckpointDir = new G4UIdirectory("/run/checkpoint/");
+  fCheckpointDir->SetGuidance("periodic snapshots of the run, see /run/resume");
+
+  fEveryCmd = new G4UIcmdWithAnInteger("/run/checkpoint/every", this);
+  fEveryCmd->SetGuidance("Write a checkpoint every nbOfEvents events (0 for none),");
+  fEveryCmd->SetGuidance("and start a new analysis file <fileName>_<k>.");
+  fEveryCmd->SetGuidance("Sequential mode only.");
+  fEveryCmd->SetParameterName("nbOfEvents", false);
+  fEveryCmd->SetRange("nbOfEvents>=0");
+  fEveryCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fEveryCmd->SetToBeBroadcasted(false);
+
+  fFileCmd = new G4UIcmdWithAString("/run/checkpoint/file", this);
+  fFileCmd->SetGuidance("Checkpoint file, overwritten by each checkpoint.");
+  fFileCmd->SetParameterName("fileName", false);
+  fFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fFileCmd->SetToBeBroadcasted(false);
+
+  fResumeCmd = new G4UIcmdWithAString("/run/resume", this);
+  fResumeCmd->SetGuidance("Continue the run a checkpoint was taken from: restores it and");
+  fResumeCmd->SetGuidance("processes the remaining events. Execute the macro of that run");
+  fResumeCmd->SetGuidance("first, without its beamOn. Sequential mode only.");
+  fResumeCmd->SetParameterName("checkpoint", false);
+  fResumeCmd->AvailableForStates(G4State_Idle);
+  fResumeCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+CheckpointMessenger::~CheckpointMessenger()
+{
+  delete fEveryCmd;
+  delete fFileCmd;
+  delete fResumeCmd;
+  delete fCheckpointDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void CheckpointMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if (command == fEveryCmd) {
+    Checkpoint::SetInterval(fEveryCmd->GetNewIntValue(newValue));
+  }
+
+  if (command == fFileCmd) {
+    Checkpoint::SetFileName(newValue);
+  }
+
+  if (command == fResumeCmd) {
+    G4int nbOfEventsLeft = 0;
+    if (!Checkpoint::Resume(newValue, nbOfEventsLeft)) return;
+    G4RunManager::GetRunManager()->BeamOn(nbOfEventsLeft);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
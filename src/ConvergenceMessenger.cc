@@ -0,0 +1,99 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ConvergenceMessenger.cc
+/// \brief Implementation of the ConvergenceMessenger class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "ConvergenceMessenger.hh"
+
+#include "ConvergenceMonitor.hh"
+#include "DetectorConstruction.hh"
+
+#include "G4RunManager.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ConvergenceMessenger::ConvergenceMessenger(DetectorConstruction* det) : fDetector(det)
+{
+  fBeamOnUntilCmd = new G4UIcommand("/run/beamOnUntil", this);
+  fBeamOnUntilCmd->SetGuidance("Start a run which ends once the relative error of the mean");
+  fBeamOnUntilCmd->SetGuidance("of a tally per event is below a target, or after maxEvents.");
+  fBeamOnUntilCmd->SetGuidance("Tallies: edep, eflow, slab<i> (deposit in monitor slab i),");
+  fBeamOnUntilCmd->SetGuidance("flux:<particle> (particles of a species leaving the world).");
+
+  auto tallyPrm = new G4UIparameter("tally", 's', false);
+  tallyPrm->SetGuidance("edep, eflow, slab<i> or flux:<particle>");
+  fBeamOnUntilCmd->SetParameter(tallyPrm);
+
+  auto errorPrm = new G4UIparameter("relErr", 'd', false);
+  errorPrm->SetGuidance("target relative error of the mean");
+  errorPrm->SetParameterRange("relErr>0.");
+  fBeamOnUntilCmd->SetParameter(errorPrm);
+
+  auto maxEventsPrm = new G4UIparameter("maxEvents", 'i', false);
+  maxEventsPrm->SetGuidance("number of events if the target is not reached");
+  maxEventsPrm->SetParameterRange("maxEvents>0");
+  fBeamOnUntilCmd->SetParameter(maxEventsPrm);
+
+  fBeamOnUntilCmd->AvailableForStates(G4State_Idle);
+  fBeamOnUntilCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ConvergenceMessenger::~ConvergenceMessenger()
+{
+  delete fBeamOnUntilCmd;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ConvergenceMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if (command == fBeamOnUntilCmd) {
+    G4String tally;
+    G4double relativeError;
+    G4int maxEvents;
+    std::istringstream is(newValue);
+    is >> tally >> relativeError >> maxEvents;
+    if (!ConvergenceMonitor::Start(tally, relativeError, fDetector->GetNbOfAbsor())) {
+      G4cout << "\n --->warning from ConvergenceMessenger : unknown tally " << tally
+             << " Command refused" << G4endl;
+      return;
+    }
+    G4RunManager::GetRunManager()->BeamOn(maxEvents);
+    ConvergenceMonitor::Stop();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,163 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ConvergenceMonitor.cc
+/// \brief Implementation of the ConvergenceMonitor class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "ConvergenceMonitor.hh"
+
+#include "G4AutoLock.hh"
+#include "G4ParticleTable.hh"
+
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+
+namespace
+{
+G4Mutex monitorMutex = G4MUTEX_INITIALIZER;
+ConvergenceMonitor::Tally monitorTally;
+G4double monitorTarget = 0.;
+ConvergenceMonitor::Welford monitorEstimate;
+std::atomic<G4bool> monitorConverged(false);
+}  // namespace
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ConvergenceMonitor::Welford::Add(G4double value)
+{
+  fCount++;
+  const G4double delta = value - fMean;
+  fMean += delta / fCount;
+  fM2 += delta * (value - fMean);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ConvergenceMonitor::Welford::Merge(const Welford& other)
+{
+  if (other.fCount == 0) return;
+  const G4long count = fCount + other.fCount;
+  const G4double delta = other.fMean - fMean;
+  fMean += delta * other.fCount / count;
+  fM2 += other.fM2 + delta * delta * fCount * other.fCount / count;
+  fCount = count;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double ConvergenceMonitor::Welford::GetRelativeError() const
+{
+  if (fCount < 2 || fMean == 0.) return DBL_MAX;
+  const G4double variance = fM2 / (fCount - 1);
+  return std::sqrt(variance / fCount) / std::abs(fMean);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ConvergenceMonitor::Start(const G4String& name, G4double relativeError,
+                                 G4int nbOfAbsor)
+{
+  Tally tally;
+  tally.fName = name;
+  if (name == "edep") {
+    tally.fKind = kEdep;
+  }
+  else if (name == "eflow") {
+    tally.fKind = kEflow;
+  }
+  else if (name.compare(0, 4, "slab") == 0) {
+    const G4int slab = std::atoi(name.substr(4).c_str());
+    if (slab < 1 || slab > nbOfAbsor) return false;
+    tally.fKind = kSlabEdep;
+    tally.fSlab = slab - 1;
+  }
+  else if (name.compare(0, 5, "flux:") == 0) {
+    tally.fParticle = G4ParticleTable::GetParticleTable()->FindParticle(name.substr(5));
+    if (tally.fParticle == nullptr) return false;
+    tally.fKind = kFlux;
+  }
+  else {
+    return false;
+  }
+
+  G4AutoLock lock(&monitorMutex);
+  monitorTally = tally;
+  monitorTarget = relativeError;
+  monitorEstimate = Welford();
+  monitorConverged = false;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ConvergenceMonitor::Stop()
+{
+  G4AutoLock lock(&monitorMutex);
+  monitorTally = Tally();
+  monitorConverged = false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ConvergenceMonitor::Tally ConvergenceMonitor::GetTally()
+{
+  G4AutoLock lock(&monitorMutex);
+  return monitorTally;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double ConvergenceMonitor::GetTarget()
+{
+  G4AutoLock lock(&monitorMutex);
+  return monitorTarget;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ConvergenceMonitor::AddBatch(const Welford& batch)
+{
+  G4AutoLock lock(&monitorMutex);
+  monitorEstimate.Merge(batch);
+  if (monitorEstimate.fCount >= kMinEvents
+      && monitorEstimate.GetRelativeError() <= monitorTarget)
+    monitorConverged = true;
+  return monitorConverged;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ConvergenceMonitor::IsConverged()
+{
+  return monitorConverged;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
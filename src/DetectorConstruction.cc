@@ -33,6 +33,8 @@
 #include "DetectorConstruction.hh"
 
 #include "DetectorMessenger.hh"
+#include "NeutronKiller.hh"
+#include "ScoringSD.hh"
 
 #include "G4Box.hh"
 #include "G4GeometryManager.hh"
@@ -44,6 +46,7 @@
 #include "G4PhysicalConstants.hh"
 #include "G4PhysicalVolumeStore.hh"
 #include "G4RunManager.hh"
+#include "G4SDManager.hh"
 #include "G4SolidStore.hh"
 #include "G4SubtractionSolid.hh"
 #include "G4SystemOfUnits.hh"
@@ -229,6 +232,8 @@ G4VPhysicalVolume *DetectorConstruction::ConstructVolumes() {
   G4PhysicalVolumeStore::GetInstance()->Clean();
   G4LogicalVolumeStore::GetInstance()->Clean();
   G4SolidStore::GetInstance()->Clean();
+  fScoringVolumes.clear();
+  fAbsorberVolumes.clear();
 
   // ################################################################################//
   // World
@@ -345,6 +350,12 @@ G4VPhysicalVolume *DetectorConstruction::ConstructVolumes() {
     auto physiSlab_AlongY_2 = new G4PVPlacement(
         0, {0., (fWorldSizeX * .99 / 2. + 1.6 * mm), 0.}, logsiSlab_AlongY_2,
         "physiSlab_AlongY_2", lWorld, false, 0);
+
+    // The slabs get a sensitive detector in ConstructSDandField()
+    fScoringVolumes.emplace_back(logsiSlab_AlongY_1, kSiliconY1);
+    fScoringVolumes.emplace_back(logsiSlab_AlongY_2, kSiliconY2);
+    fScoringVolumes.emplace_back(logsiSlab_AlongZ_1, kSiliconZ1);
+    fScoringVolumes.emplace_back(logsiSlab_AlongZ_2, kSiliconZ2);
   }
   // ################################################################################//
   // Monitor geometry: multiple slabs
@@ -440,13 +451,19 @@ G4VPhysicalVolume *DetectorConstruction::ConstructVolumes() {
     G4double xcenter = fXfront[k] + 0.5 * fAbsorThickness[k];
     G4ThreeVector position = G4ThreeVector(xcenter, 0., 0.);
 
-    new G4PVPlacement(0,          // no rotation
-                      position,   // position
-                      logicAbsor, // logical volume
-                      matname,    // name
-                      lWorld,     // mother
-                      false,      // no boulean operat
-                      k);         // copy number
+    auto physiAbsor = new G4PVPlacement(0,          // no rotation
+                                        position,   // position
+                                        logicAbsor, // logical volume
+                                        matname,    // name
+                                        lWorld,     // mother
+                                        false,      // no boulean operat
+                                        k);         // copy number
+    fAbsorberVolumes.push_back(physiAbsor);
+
+    // The neutron converter gets a sensitive detector as well
+    if (matname == "B4C_enriched") {
+      fScoringVolumes.emplace_back(logicAbsor, kBoronConverter);
+    }
 
     // Set visualization attributes
     G4VisAttributes *AbsorAtt;
@@ -461,6 +478,14 @@ G4VPhysicalVolume *DetectorConstruction::ConstructVolumes() {
       logicAbsor->SetVisAttributes(AbsorAtt);
     }
   }
+
+  // The gaps between the slabs move the stack off the origin, the neutron
+  // killer envelope is centred on it
+  G4ThreeVector monitorCentre;
+  if (fNbOfAbsor > 0)
+    monitorCentre.setX(0.5 * (fXfront[1] + fXfront[fNbOfAbsor] +
+                              fAbsorThickness[fNbOfAbsor]));
+  NeutronKiller::SetEnvelopeCentre(monitorCentre);
   // ###############################################################################//
   // PrintParameters();
 
@@ -471,6 +496,24 @@ G4VPhysicalVolume *DetectorConstruction::ConstructVolumes() {
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void DetectorConstruction::ConstructSDandField() {
+  // Called on each worker, again after every geometry change: the detectors
+  // are created once per thread and attached to the new logical volumes.
+  G4SDManager *sdManager = G4SDManager::GetSDMpointer();
+  for (const auto &[logicVolume, volume] : fScoringVolumes) {
+    G4VSensitiveDetector *sd =
+        sdManager->FindSensitiveDetector(ScoringSD::GetDetectorName(volume),
+                                         false);
+    if (sd == nullptr) {
+      sd = new ScoringSD(volume);
+      sdManager->AddNewDetector(sd);
+    }
+    SetSensitiveDetector(logicVolume, sd);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 // void DetectorConstruction::PrintParameters() {
 //   G4cout << "\n The Absorber  is a cylinder of " << fAbsorMaterial->GetName()
 //          << "  radius = " << G4BestUnit(fAbsorRadius, "Length")
@@ -640,4 +683,24 @@ void DetectorConstruction::SetSiliconSlabs(G4int val) {
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+G4int DetectorConstruction::GetAbsorberIndex(
+    const G4VPhysicalVolume *pv) const {
+  for (std::size_t k = 0; k < fAbsorberVolumes.size(); ++k) {
+    if (fAbsorberVolumes[k] == pv)
+      return G4int(k);
+  }
+  return -1;
+}
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double DetectorConstruction::GetScoringMass(ScoringVolume volume) const {
+  // Every B4C_enriched layer is a kBoronConverter, their deposits are summed
+  G4double mass = 0.;
+  for (const auto &[logicVolume, scoringVolume] : fScoringVolumes) {
+    if (scoringVolume == volume)
+      mass += logicVolume->GetMass();
+  }
+  return mass;
+}
+
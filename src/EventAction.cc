@@ -31,15 +31,37 @@
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 #include "EventAction.hh"
+#include "Checkpoint.hh"
 #include "HistoManager.hh"
+#include "ParticleClassifier.hh"
+#include "ProcessClassifier.hh"
 #include "Run.hh"
+#include "ScoringHit.hh"
+#include "ScoringSD.hh"
+#include "StepNames.hh"
+#include "StepProfile.hh"
+#include "TrackInformation.hh"
+
+#include "G4Electron.hh"
 #include "G4Event.hh"
+#include "G4EventManager.hh"
+#include "G4HCofThisEvent.hh"
+#include "G4LogicalVolume.hh"
+#include "G4HadronicProcessType.hh"
+#include "G4Material.hh"
+#include "G4Neutron.hh"
 #include "G4RunManager.hh"
+#include "G4SDManager.hh"
+#include "G4SystemOfUnits.hh"
 #include "G4UnitsTable.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 void EventAction::BeginOfEventAction(const G4Event *anEvent) {
+  // the ids of a resumed run continue those of the run it comes from
+  if (Checkpoint::GetEventOffset() > 0)
+    G4EventManager::GetEventManager()->GetNonconstCurrentEvent()->SetEventID(
+        anEvent->GetEventID() + Checkpoint::GetEventOffset());
 
   //  Print the Run status
   G4int eventID = anEvent->GetEventID();
@@ -57,8 +79,30 @@ void EventAction::BeginOfEventAction(const G4Event *anEvent) {
               << std::endl;
   }
 
+  // Production cuts may change between runs, rebuild the dE/dx tables
+  if (run->GetRunID() != fStoppingPowerRunID) {
+    fStoppingPower.Clear();
+    fStoppingPowerRunID = run->GetRunID();
+  }
+
+  // The tally of /run/beamOnUntil is chosen on the master before the run
+  if (run->GetRunID() != fTallyRunID) {
+    fTally = ConvergenceMonitor::GetTally();
+    fTallyBatch = ConvergenceMonitor::Welford();
+    fTallyRunID = run->GetRunID();
+  }
+  fTallyValue = 0.;
+
   fTotalEnergyDeposit = 0.;
   fTotalEnergyFlow = 0.;
+
+  // clear() keeps the capacity, the buffers stop allocating after a few events
+  fNeutronCaptureRows.clear();
+  fExitWorldRows.clear();
+  fTrackSummaryRows.clear();
+
+  if (TrajectoryStore *trajectories = GetTrajectoryStore())
+    trajectories->BeginOfEvent(anEvent);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -71,7 +115,7 @@ void EventAction::AddEflow(G4double Eflow) { fTotalEnergyFlow += Eflow; }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void EventAction::EndOfEventAction(const G4Event *) {
+void EventAction::EndOfEventAction(const G4Event *anEvent) {
   Run *run = static_cast<Run *>(
       G4RunManager::GetRunManager()->GetNonConstCurrentRun());
 
@@ -80,6 +124,367 @@ void EventAction::EndOfEventAction(const G4Event *) {
 
   G4AnalysisManager::Instance()->FillH1(1, fTotalEnergyDeposit);
   G4AnalysisManager::Instance()->FillH1(3, fTotalEnergyFlow);
+
+  if (fTally.fKind != ConvergenceMonitor::kOff)
+    EndOfEventTally(run);
+
+  // The dose is summed over every event, triggered or not
+  AddDose(anEvent, run);
+
+  // Nothing is written for events which do not pass the triggers
+  G4bool passed = true;
+  {
+    PROFILE_STEP_SECTION(kTriggers);
+    passed = PassesTriggers(anEvent);
+  }
+  if (TrajectoryStore *trajectories = GetTrajectoryStore())
+    trajectories->EndOfEvent(anEvent, passed && HasTriggers());
+  if (passed) {
+    {
+      PROFILE_STEP_SECTION(kWriteStaged);
+      WriteStagedRows();
+    }
+    {
+      PROFILE_STEP_SECTION(kWriteHits);
+      WriteScoringHits(anEvent);
+    }
+    if (fSaveSiliconSegments == 1) {
+      PROFILE_STEP_SECTION(kWriteSegments);
+      WriteSiliconSegments(anEvent);
+    }
+  }
+
+  // once the rows of the event are in the analysis file
+  Checkpoint::EndOfEvent(run);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventAction::EndOfEventTally(Run *run) {
+  G4double value = fTallyValue;
+  if (fTally.fKind == ConvergenceMonitor::kEdep)
+    value = fTotalEnergyDeposit;
+  else if (fTally.fKind == ConvergenceMonitor::kEflow)
+    value = fTotalEnergyFlow;
+  run->AddTallyValue(value);
+
+  // The batches of all threads are merged into one estimate
+  fTallyBatch.Add(value);
+  if (fTallyBatch.fCount >= ConvergenceMonitor::kBatchSize) {
+    ConvergenceMonitor::AddBatch(fTallyBatch);
+    fTallyBatch = ConvergenceMonitor::Welford();
+  }
+
+  // soft abort: the current event is completed
+  if (ConvergenceMonitor::IsConverged())
+    G4RunManager::GetRunManager()->AbortRun(true);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventAction::AddDose(const G4Event *anEvent, Run *run) {
+  ParticleClassifier *classifier = ParticleClassifier::Instance();
+  for (G4int v = 0; v < kNbScoringVolumes; ++v) {
+    const ScoringVolume volume = static_cast<ScoringVolume>(v);
+    auto hits = static_cast<ScoringHitsCollection *>(
+        GetHitsCollection(anEvent, volume, ScoringSD::kStepHits));
+    if (hits == nullptr)
+      continue;
+
+    for (std::size_t i = 0; i < hits->entries(); ++i) {
+      const ScoringHit *hit = (*hits)[i];
+      const G4double edep = hit->GetEdep() * hit->GetWeight();
+      if (edep <= 0.)
+        continue;
+      run->AddDose(volume, DoseSummaryRow::kTotal, edep);
+
+      // Particle classes of Results/DoseCalculation.cxx
+      const G4ParticleDefinition *particle = hit->GetParticle();
+      const G4int ancestry = hit->GetAncestry();
+      G4int doseClass = -1;
+      switch (classifier->Classify(particle)) {
+      case ParticleClassifier::kElectron:
+        doseClass = (particle == G4Electron::Electron() &&
+                     (ancestry & TrackInformation::kCreatedByPhoton))
+                        ? DoseSummaryRow::kGamma
+                        : DoseSummaryRow::kElectron;
+        break;
+      case ParticleClassifier::kGamma:
+        doseClass = DoseSummaryRow::kGamma;
+        break;
+      case ParticleClassifier::kProton:
+        doseClass = DoseSummaryRow::kProton;
+        break;
+      case ParticleClassifier::kOtherIon:
+        // silicon recoils and phosphorus from 30Si(n,g)
+        if (particle->GetAtomicNumber() == 14 ||
+            particle->GetAtomicNumber() == 15)
+          doseClass = DoseSummaryRow::kNucleus;
+        break;
+      default:
+        break;
+      }
+      if (doseClass >= 0)
+        run->AddDose(volume, doseClass, edep);
+
+      if (ancestry & TrackInformation::kFromB10Capture)
+        run->AddDose(volume, DoseSummaryRow::kB10Capture, edep);
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventAction::ClearTriggers() {
+  fCaptureTrigger = false;
+  for (G4int v = 0; v < kNbScoringVolumes; ++v)
+    fEdepTrigger[v] = -1.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool EventAction::HasTriggers() const {
+  G4bool hasTrigger = fCaptureTrigger;
+  for (G4int v = 0; v < kNbScoringVolumes; ++v)
+    hasTrigger = hasTrigger || (fEdepTrigger[v] >= 0.);
+  return hasTrigger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool EventAction::PassesTriggers(const G4Event *anEvent) {
+  if (!HasTriggers())
+    return true;
+
+  if (fCaptureTrigger && HasConverterCapture(anEvent))
+    return true;
+
+  for (G4int v = 0; v < kNbScoringVolumes; ++v) {
+    if (fEdepTrigger[v] < 0.)
+      continue;
+    if (GetScoredEdep(anEvent, static_cast<ScoringVolume>(v)) > fEdepTrigger[v])
+      return true;
+  }
+  return false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool EventAction::HasConverterCapture(const G4Event *anEvent) {
+  auto hits = static_cast<ScoringHitsCollection *>(
+      GetHitsCollection(anEvent, kBoronConverter, ScoringSD::kStepHits));
+  if (hits == nullptr)
+    return false;
+
+  // A neutron absorbed in the B4C layer: 10B(n,alpha)7Li is a neutron
+  // inelastic reaction for the HP models, radiative capture is nCapture
+  for (std::size_t i = 0; i < hits->entries(); ++i) {
+    const ScoringHit *hit = (*hits)[i];
+    if (hit->GetParticle() != G4Neutron::Neutron())
+      continue;
+    const ProcessInfo &info =
+        ProcessClassifier::Instance()->Classify(hit->GetProcess());
+    if (info.fIsHadronic &&
+        (info.fSubType == fHadronInelastic || info.fSubType == fCapture))
+      return true;
+  }
+  return false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double EventAction::GetScoredEdep(const G4Event *anEvent,
+                                    ScoringVolume volume) {
+  auto hits = static_cast<ScoringHitsCollection *>(
+      GetHitsCollection(anEvent, volume, ScoringSD::kStepHits));
+  if (hits == nullptr)
+    return 0.;
+
+  G4double edep = 0.;
+  for (std::size_t i = 0; i < hits->entries(); ++i)
+    edep += (*hits)[i]->GetEdep();
+  return edep;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4VHitsCollection *EventAction::GetHitsCollection(const G4Event *anEvent,
+                                                  ScoringVolume volume,
+                                                  G4int collection) {
+  G4HCofThisEvent *hce = anEvent->GetHCofThisEvent();
+  if (hce == nullptr)
+    return nullptr;
+
+  G4int &hcID = (collection == ScoringSD::kSegments) ? fSegmentsHCID[volume]
+                                                     : fScoringHCID[volume];
+  // The silicon slabs are optional: retry the lookup until they exist
+  if (hcID < 0)
+    hcID = G4SDManager::GetSDMpointer()->GetCollectionID(
+        ScoringSD::GetCollectionName(
+            volume, static_cast<ScoringSD::Collection>(collection)));
+  if (hcID < 0)
+    return nullptr;
+
+  return hce->GetHC(hcID);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventAction::WriteStagedRows() {
+  const Ntuples *ntuples = Ntuples::Instance();
+  for (const NeutronCaptureRow &row : fNeutronCaptureRows)
+    ntuples->NeutronCapture().Fill(row);
+  for (const ExitWorldRow &row : fExitWorldRows)
+    ntuples->ExitWorld().Fill(row);
+  for (const TrackSummaryRow &row : fTrackSummaryRows)
+    ntuples->TrackSummary().Fill(row);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventAction::WriteScoringHits(const G4Event *anEvent) {
+  const Ntuples *ntuples = Ntuples::Instance();
+  const G4int eventID = anEvent->GetEventID();
+
+  for (G4int v = 0; v < kNbScoringVolumes; ++v) {
+    const auto volume = static_cast<ScoringVolume>(v);
+    const G4bool isSilicon = (volume != kBoronConverter);
+    if (isSilicon && fSaveSiliconData != 1)
+      continue;
+
+    auto hits = static_cast<ScoringHitsCollection *>(
+        GetHitsCollection(anEvent, volume, ScoringSD::kStepHits));
+    if (hits == nullptr)
+      continue;
+
+    for (std::size_t i = 0; i < hits->entries(); ++i) {
+      const ScoringHit *hit = (*hits)[i];
+      const G4ThreeVector &position = hit->GetPosition();
+
+      if (!isSilicon) {
+        BoronEdepRow row;
+        row.fEvent = eventID;
+        row.fParticleName = &hit->GetParticle()->GetParticleName();
+        row.fParentID = hit->GetParentID();
+        row.fParticleID = hit->GetTrackID();
+        row.fStepNumber = hit->GetStepNumber();
+        row.fX = position[0] / mm;
+        row.fY = position[1] / mm;
+        row.fZ = position[2] / mm;
+        row.fInteractionType = &StepNames::Process(hit->GetProcess());
+        row.fTargetIsotope =
+            &StepNames::Target(hit->GetTargetIsotope(), hit->GetPostVolume());
+        row.fEdep = hit->GetEdep() / CLHEP::MeV;
+        row.fCreatorProcessName =
+            &StepNames::Creator(hit->GetParentID(), hit->GetCreatorProcess());
+        row.fAncestry = hit->GetAncestry();
+        row.fWeight = hit->GetWeight();
+        ntuples->BoronEdep().Fill(row);
+        continue;
+      }
+
+      SiliconEdepRow row;
+      FillSiliconRow(eventID, hit, row);
+      ntuples->SiliconEdep(volume).Fill(row);
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventAction::WriteSiliconSegments(const G4Event *anEvent) {
+  const Ntuples *ntuples = Ntuples::Instance();
+  const G4int eventID = anEvent->GetEventID();
+
+  for (G4int v = kSiliconY1; v <= kSiliconZ2; ++v) {
+    const auto volume = static_cast<ScoringVolume>(v);
+    auto segments = static_cast<ScoringSegmentsCollection *>(
+        GetHitsCollection(anEvent, volume, ScoringSD::kSegments));
+    if (segments == nullptr)
+      continue;
+
+    for (std::size_t i = 0; i < segments->entries(); ++i) {
+      const ScoringSegment *segment = (*segments)[i];
+      // passages without deposit do not contribute to the dose
+      if (segment->GetEdep() <= 0.)
+        continue;
+
+      const G4ThreeVector &entry = segment->GetEntryPosition();
+      const G4ThreeVector &exit = segment->GetExitPosition();
+      SiliconSegmentRow row;
+      row.fEvent = eventID;
+      row.fParticleName = &segment->GetParticle()->GetParticleName();
+      row.fParentID = segment->GetParentID();
+      row.fParticleID = segment->GetTrackID();
+      row.fEntryX = entry[0] / mm;
+      row.fEntryY = entry[1] / mm;
+      row.fEntryZ = entry[2] / mm;
+      row.fExitX = exit[0] / mm;
+      row.fExitY = exit[1] / mm;
+      row.fExitZ = exit[2] / mm;
+      row.fEntryKinEnergy = segment->GetEntryKineticEnergy() / MeV;
+      row.fEdep = segment->GetEdep() / MeV;
+      row.fTrackLength = segment->GetTrackLength() / mm;
+      row.fMeandEdx = segment->GetMeanDEDX() / (MeV / cm);
+      row.fMaxdEdx = segment->GetMaxDEDX() / (MeV / cm);
+      row.fNbSteps = segment->GetNbOfSteps();
+      row.fCreatorProcessName = &StepNames::Creator(
+          segment->GetParentID(), segment->GetCreatorProcess());
+      row.fVertexVolumeName = &segment->GetVertexVolume()->GetName();
+      row.fAncestry = segment->GetAncestry();
+      row.fWeight = segment->GetWeight();
+      ntuples->SiliconSegment(volume).Fill(row);
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventAction::FillSiliconRow(G4int eventID, const ScoringHit *hit,
+                                 SiliconEdepRow &row) {
+  const G4ParticleDefinition *particle = hit->GetParticle();
+  const G4ThreeVector &position = hit->GetPosition();
+  const G4double edep = hit->GetEdep() / CLHEP::MeV;
+
+  // Stopping power from the cached restricted and total dE/dx tables
+  const G4Material *material = hit->GetMaterial();
+  G4double density = material->GetDensity() / (g / cm3);
+  G4double preKineticEnergy = hit->GetPreKineticEnergy() * MeV;
+  G4double dEdxTable = 0., dEdxFull = 0.;
+  if (particle->GetPDGCharge() != 0.) {
+    PROFILE_STEP_SECTION(kStoppingPower);
+    fStoppingPower.GetDEDX(preKineticEnergy, particle, material, dEdxTable,
+                           dEdxFull);
+  }
+  G4double stopTable = dEdxTable / density;
+  G4double stopFull = dEdxFull / density;
+
+  // Stopping power from simulation
+  G4double stepLength = hit->GetStepLength() / cm2;
+  G4double meandEdx = edep / stepLength;
+  G4double stopPower = meandEdx / density;
+
+  row.fEvent = eventID;
+  row.fParticleName = &particle->GetParticleName();
+  row.fParentID = hit->GetParentID();
+  row.fParticleID = hit->GetTrackID();
+  row.fStepNumber = hit->GetStepNumber();
+  row.fX = position[0] / mm;
+  row.fY = position[1] / mm;
+  row.fZ = position[2] / mm;
+  row.fInteractionType = &StepNames::Process(hit->GetProcess());
+  row.fTargetIsotope =
+      &StepNames::Target(hit->GetTargetIsotope(), hit->GetPostVolume());
+  row.fEdep = edep;
+  row.fStopTable = stopTable / (CLHEP::MeV * CLHEP::cm2 / CLHEP::g);
+  row.fStopFull = stopFull / (CLHEP::MeV * CLHEP::cm2 / CLHEP::g);
+  row.fMeandEdx = meandEdx / (CLHEP::MeV / CLHEP::cm);
+  row.fStopPower = stopPower / (CLHEP::MeV * CLHEP::cm2 / CLHEP::g);
+  row.fCreatorProcessName =
+      &StepNames::Creator(hit->GetParentID(), hit->GetCreatorProcess());
+  row.fVertexVolumeName = &hit->GetVertexVolume()->GetName();
+  row.fAncestry = hit->GetAncestry();
+  row.fWeight = hit->GetWeight();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
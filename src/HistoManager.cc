@@ -31,13 +31,54 @@
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 #include "HistoManager.hh"
+#include "HistoMessenger.hh"
+#include "Ntuples.hh"
+#include "ParticleClassifier.hh"
 
+#include "G4SystemOfUnits.hh"
 #include "G4UnitsTable.hh"
+#include "tools/histo/h1d"
+#include "tools/histo/h2d"
+#include <cmath>
+#include <istream>
 #include <iterator>
+#include <ostream>
+#include <sstream>
+
+static_assert(HistoManager::kNbMaps ==
+                  ParticleClassifier::kNbCategories * HistoManager::kNbFaces,
+              "one map per particle category and world face");
+
+namespace {
+G4ThreadLocal HistoManager *threadHistoManager = nullptr;
+
+const G4String particle_types[] = {
+    "gamma",        "e+-",
+    "neutrons",     "protons",
+    "deuterons",    "alphas",
+    "other ions",   "other baryons",
+    "other mesons", "other leptons (neutrinos)"};
+} // namespace
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-HistoManager::HistoManager() { Book(); }
+HistoManager::HistoManager() {
+  Book();
+  fHistoMessenger = new HistoMessenger(this);
+  threadHistoManager = this;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+HistoManager::~HistoManager() {
+  delete fHistoMessenger;
+  if (threadHistoManager == this)
+    threadHistoManager = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+HistoManager *HistoManager::Instance() { return threadHistoManager; }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -84,39 +125,317 @@ void HistoManager::Book() {
     analysisManager->SetH1Activation(ih, false);
   }
 
-  // create 2D histograms for particle flux
-  G4int nbins2D = 110;
-  G4double vmin2D = -550.;
-  G4double vmax2D = 550.;
+  // The per-face spectra and the maps are booked by their binning command
+}
 
-  const G4int kHisto2D = 6;
-  const G4int kPArticleHisto2D = 10;
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-  const G4String particle_types[] = {
-      "gamma",        "e+-",
-      "neutrons",     "protons",
-      "deuterons",    "alphas",
-      "other ions",   "other baryons",
-      "other mesons", "other leptons (neutrinos)"};
+void HistoManager::BookMaps() {
+  // Booked in one go after the H1, which gives them the ids 0-59
+  G4AnalysisManager *analysisManager = G4AnalysisManager::Instance();
   const G4String histo_types[] = {
       "XY_-Z Particle Count", "XY_+Z Particle Count", "ZY_-X Particle Count",
       "ZY_+X Particle Count", "ZX_-Y Particle Count", "ZX_+Y Particle Count"};
+  G4int nbins2D = 110;
+  G4double vmin2D = -550.;
+  G4double vmax2D = 550.;
 
   G4int hist_id_counter = 1;
-
-  for (G4int i = 0; i < kHisto2D; i++) {
-    for (G4int j = 0; j < kPArticleHisto2D; j++) {
+  for (G4int i = 0; i < kNbFaces; i++) {
+    for (G4int j = 0; j < ParticleClassifier::kNbCategories; j++) {
       std::ostringstream mystr;
       mystr << hist_id_counter << std::endl;
       G4int ih = analysisManager->CreateH2(
           mystr.str().c_str(), histo_types[i] + " of " + particle_types[j],
           nbins2D, vmin2D, vmax2D, nbins2D, vmin2D, vmax2D);
       analysisManager->SetH2Activation(ih, false);
-      // std::cout << "Created 2D histo ID: " << ih << std::endl;
       hist_id_counter++;
     }
   }
+  fMapsBooked = true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HistoManager::BookFaceSpectra() {
+  // energy spectra per particle category and world face, after the first
+  // H1 so that the existing ids do not move
+  G4AnalysisManager *analysisManager = G4AnalysisManager::Instance();
+  const G4String face_types[] = {"-Z", "+Z", "-X", "+X", "-Y", "+Y"};
+  for (G4int i = 0; i < kNbFaces; i++) {
+    for (G4int j = 0; j < ParticleClassifier::kNbCategories; j++) {
+      const G4int k =
+          kFirstFaceSpectrum + j + ParticleClassifier::kNbCategories * i;
+      G4int ih = analysisManager->CreateH1(
+          std::to_string(k),
+          "energy spectrum of " + particle_types[j] + " leaving through " +
+              face_types[i],
+          100, 0., 100.); // binning of Book(), reset by SetSpectrumBinning
+      analysisManager->SetH1Activation(ih, false);
+    }
+  }
+  fFaceSpectraBooked = true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HistoManager::SetMapBinning(G4int nbins, G4double halfWidth,
+                                 const G4String &unit) {
+  fMapNbins = nbins;
+  fMapHalfWidth = halfWidth;
+  fMapUnit = unit;
+
+  // The sparse maps live in the Run, nothing to book
+  if (!fSparseMaps) {
+    if (!fMapsBooked)
+      BookMaps();
+    // The limits are given in internal units, the axes are shown in unit
+    G4AnalysisManager *analysisManager = G4AnalysisManager::Instance();
+    for (G4int ih = 0; ih < kNbMaps; ih++) {
+      analysisManager->SetH2(ih, nbins, -halfWidth, halfWidth, nbins,
+                             -halfWidth, halfWidth, unit, unit);
+      analysisManager->SetH2Activation(ih, true);
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HistoManager::SetSparseMaps(G4bool val) {
+  fSparseMaps = val;
+  if (fSparseMaps && fMapsBooked) {
+    G4AnalysisManager *analysisManager = G4AnalysisManager::Instance();
+    for (G4int ih = 0; ih < kNbMaps; ih++)
+      analysisManager->SetH2Activation(ih, false);
+  }
+  // keep the binning already set, in the new storage
+  if (fMapNbins > 0)
+    SetMapBinning(fMapNbins, fMapHalfWidth, fMapUnit);
+}
 
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HistoManager::SetSpectrumBinning(G4int nbins, G4double emin,
+                                      G4double emax, const G4String &unit,
+                                      const G4String &binScheme) {
+  fLogSpectra = false;
+  if (!fFaceSpectraBooked)
+    BookFaceSpectra();
+  G4AnalysisManager *analysisManager = G4AnalysisManager::Instance();
+  const G4int last = kFirstFaceSpectrum + kNbMaps;
+  for (G4int ih = kFirstSpectrum; ih < last; ih++) {
+    analysisManager->SetH1(ih, nbins, emin, emax, unit, "none", binScheme);
+    analysisManager->SetH1Activation(ih, true);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HistoManager::SetLogSpectrumBinning(G4int binsPerOctave, G4double emin,
+                                         G4double emax, const G4String &unit) {
+  fLogSpectra = true;
+  fBinsPerOctave = binsPerOctave;
+  fLogEmin = emin;
+  fLogEmax = emax;
+  fLogUnit = unit;
+  if (!fFaceSpectraBooked)
+    BookFaceSpectra();
+
+  // The H1 take the edges of the LogH1, the edges are in internal units
+  const std::vector<G4double> edges = NewLogSpectrum().GetEdges();
+  G4AnalysisManager *analysisManager = G4AnalysisManager::Instance();
+  const G4int last = kFirstFaceSpectrum + kNbMaps;
+  for (G4int ih = kFirstSpectrum; ih < last; ih++) {
+    analysisManager->SetH1(ih, edges, unit);
+    analysisManager->SetH1Activation(ih, true);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HistoManager::NormaliseFluxHistograms(G4int nbOfPrimaries) {
+  if (!fNormalise || nbOfPrimaries == 0)
+    return;
+
+  // The worker histograms are already merged into the master ones
+  G4AnalysisManager *analysisManager = G4AnalysisManager::Instance();
+  const G4int last =
+      fFaceSpectraBooked ? kFirstFaceSpectrum + kNbMaps : kFirstFaceSpectrum;
+  for (G4int ih = kFirstSpectrum; ih < last; ih++) {
+    if (analysisManager->GetH1Activation(ih))
+      analysisManager->ScaleH1(ih, 1. / nbOfPrimaries);
+  }
+
+  // fluence per cm2 and per primary. The bin area is read from the axes,
+  // which hold the values in the unit of the map: /analysis/h2/set may
+  // have rebinned them
+  if (!fMapsBooked)
+    return;
+  for (G4int ih = 0; ih < kNbMaps; ih++) {
+    if (!analysisManager->GetH2Activation(ih))
+      continue;
+    const tools::histo::h2d *h2 = analysisManager->GetH2(ih);
+    const auto &xAxis = h2->axis_x();
+    const auto &yAxis = h2->axis_y();
+    const G4double binArea =
+        (xAxis.upper_edge() - xAxis.lower_edge()) / xAxis.bins() *
+        analysisManager->GetH2XUnit(ih) *
+        (yAxis.upper_edge() - yAxis.lower_edge()) / yAxis.bins() *
+        analysisManager->GetH2YUnit(ih);
+    analysisManager->ScaleH2(ih, cm2 / (binArea * nbOfPrimaries));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SparseH2 HistoManager::NewSparseMap() const {
+  return SparseH2(fMapNbins, -fMapHalfWidth, fMapHalfWidth, fMapNbins,
+                  -fMapHalfWidth, fMapHalfWidth);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+LogH1 HistoManager::NewLogSpectrum() const {
+  return LogH1(fLogEmin, fLogEmax, fBinsPerOctave);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HistoManager::WriteLogSpectra(const std::vector<LogH1> &spectra) {
+  // The H1 of the workers stay empty, the master ones are still empty here
+  G4AnalysisManager *analysisManager = G4AnalysisManager::Instance();
+  for (std::size_t i = 0; i < spectra.size(); i++) {
+    tools::histo::h1d *h1 = analysisManager->GetH1(kFirstSpectrum + G4int(i));
+    if (h1 == nullptr)
+      continue;
+    // bins 0 and nbins + 1 are the underflow and the overflow in both;
+    // the moments use the bin centre, in the unit of the axis
+    const G4double unitValue = G4UnitDefinition::GetValueOf(fLogUnit);
+    const LogH1 &spectrum = spectra[i];
+    const G4int last = spectrum.GetNbins() + 1;
+    for (G4int bin = 0; bin <= last; bin++) {
+      const G4double sumW = spectrum.GetSumW(bin);
+      if (spectrum.GetEntries(bin) == 0.)
+        continue;
+      const G4double x = (bin == 0 || bin == last)
+                             ? 0.
+                             : spectrum.GetBinCenter(bin) / unitValue;
+      h1->set_bin_content(bin, (unsigned int)spectrum.GetEntries(bin), sumW,
+                          spectrum.GetSumW2(bin), x * sumW, x * x * sumW);
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HistoManager::WriteSparseMaps(const std::vector<SparseH2> &maps,
+                                   G4int nbOfPrimaries) {
+  if (maps.empty())
+    return;
+  const G4double binWidth = 2. * fMapHalfWidth / fMapNbins;
+  const G4double scale = (fNormalise && nbOfPrimaries > 0)
+                             ? cm2 / (binWidth * binWidth * nbOfPrimaries)
+                             : 1.;
+  SparseMapRow row;
+  for (std::size_t ih = 0; ih < maps.size(); ih++) {
+    const SparseH2 &map = maps[ih];
+    row.fMap = G4int(ih);
+    for (const auto &bin : map.GetBins()) {
+      row.fBinX = map.GetBinX(bin.first);
+      row.fBinY = map.GetBinY(bin.first);
+      row.fX = map.GetBinCenterX(row.fBinX) / mm;
+      row.fY = map.GetBinCenterY(row.fBinY) / mm;
+      row.fValue = bin.second.fSumW * scale;
+      row.fError = std::sqrt(bin.second.fSumW2) * scale;
+      Ntuples::Instance()->SparseMap().Fill(row);
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HistoManager::SaveHistograms(std::ostream &os) const {
+  // Only the filled bins, by offset in the arrays of the histogram
+  // (underflow and overflow included, x fastest for the H2)
+  G4AnalysisManager *analysisManager = G4AnalysisManager::Instance();
+  const G4int nbH1 = analysisManager->GetNofH1s();
+  os << "h1 " << nbH1 << '\n';
+  for (G4int ih = 0; ih < nbH1; ih++) {
+    const tools::histo::h1d *h1 = analysisManager->GetH1(ih, false, false);
+    const auto &entries = h1->bins_entries();
+    os << entries.size() << '\n';
+    for (std::size_t bin = 0; bin < entries.size(); bin++) {
+      if (entries[bin] == 0)
+        continue;
+      os << bin << ' ' << entries[bin] << ' ' << h1->bins_sum_w()[bin] << ' '
+         << h1->bins_sum_w2()[bin] << ' ' << h1->bins_sum_xw()[bin][0] << ' '
+         << h1->bins_sum_x2w()[bin][0] << '\n';
+    }
+    os << "-1\n";
+  }
+
+  const G4int nbH2 = analysisManager->GetNofH2s();
+  os << "h2 " << nbH2 << '\n';
+  for (G4int ih = 0; ih < nbH2; ih++) {
+    const tools::histo::h2d *h2 = analysisManager->GetH2(ih, false, false);
+    const auto &entries = h2->bins_entries();
+    os << entries.size() << '\n';
+    for (std::size_t bin = 0; bin < entries.size(); bin++) {
+      if (entries[bin] == 0)
+        continue;
+      const auto &sumXW = h2->bins_sum_xw()[bin];
+      const auto &sumX2W = h2->bins_sum_x2w()[bin];
+      os << bin << ' ' << entries[bin] << ' ' << h2->bins_sum_w()[bin] << ' '
+         << h2->bins_sum_w2()[bin] << ' ' << sumXW[0] << ' ' << sumX2W[0]
+         << ' ' << sumXW[1] << ' ' << sumX2W[1] << '\n';
+    }
+    os << "-1\n";
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool HistoManager::RestoreHistograms(std::istream &is) {
+  G4AnalysisManager *analysisManager = G4AnalysisManager::Instance();
+  G4String label;
+  G4int nbH1 = 0;
+  if (!(is >> label >> nbH1) || label != "h1" ||
+      nbH1 != analysisManager->GetNofH1s())
+    return false;
+  for (G4int ih = 0; ih < nbH1; ih++) {
+    tools::histo::h1d *h1 = analysisManager->GetH1(ih, false, false);
+    std::size_t size = 0;
+    if (!(is >> size) || size != h1->bins_entries().size())
+      return false;
+    long bin = 0;
+    while (is >> bin && bin >= 0) {
+      unsigned int entries = 0;
+      G4double sumW, sumW2, sumXW, sumX2W;
+      is >> entries >> sumW >> sumW2 >> sumXW >> sumX2W;
+      h1->set_bin_content(bin, entries, sumW, sumW2, sumXW, sumX2W);
+    }
+  }
+
+  G4int nbH2 = 0;
+  if (!(is >> label >> nbH2) || label != "h2" ||
+      nbH2 != analysisManager->GetNofH2s())
+    return false;
+  for (G4int ih = 0; ih < nbH2; ih++) {
+    tools::histo::h2d *h2 = analysisManager->GetH2(ih, false, false);
+    std::size_t size = 0;
+    if (!(is >> size) || size != h2->bins_entries().size())
+      return false;
+    const long offsetY = h2->axis_x().bins() + 2;
+    long bin = 0;
+    while (is >> bin && bin >= 0) {
+      unsigned int entries = 0;
+      G4double sumW, sumW2, sumXW, sumX2W, sumYW, sumY2W;
+      is >> entries >> sumW >> sumW2 >> sumXW >> sumX2W >> sumYW >> sumY2W;
+      h2->set_bin_content(bin % offsetY, bin / offsetY, entries, sumW, sumW2,
+                          sumXW, sumX2W, sumYW, sumY2W);
+    }
+  }
+  return !is.fail();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
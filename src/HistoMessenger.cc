@@ -0,0 +1,199 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file HistoMessenger.cc
+/// \brief Implementation of the HistoMessenger class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "HistoMessenger.hh"
+
+#include "HistoManager.hh"
+
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcommand.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIparameter.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+HistoMessenger::HistoMessenger(HistoManager* histo) : fHistoManager(histo)
+{
+  // The histograms are booked on every thread, the commands are broadcast
+  fFluxDir = new G4UIdirectory("/testhadr/flux/");
+  fFluxDir->SetGuidance("histograms of the particles leaving the world");
+
+  fMapBinningCmd = new G4UIcommand("/testhadr/flux/mapBinning", this);
+  fMapBinningCmd->SetGuidance("Binning of the fluence maps of all particles and faces,");
+  fMapBinningCmd->SetGuidance("from -halfWidth to halfWidth on both axes. Books and");
+  fMapBinningCmd->SetGuidance("activates them.");
+
+  auto nbinsPrm = new G4UIparameter("nbins", 'i', false);
+  nbinsPrm->SetParameterRange("nbins>0");
+  fMapBinningCmd->SetParameter(nbinsPrm);
+
+  auto widthPrm = new G4UIparameter("halfWidth", 'd', false);
+  widthPrm->SetParameterRange("halfWidth>0.");
+  fMapBinningCmd->SetParameter(widthPrm);
+
+  auto lengthUnitPrm = new G4UIparameter("unit", 's', true);
+  lengthUnitPrm->SetDefaultValue("mm");
+  lengthUnitPrm->SetParameterCandidates(G4UIcommand::UnitsList("Length"));
+  fMapBinningCmd->SetParameter(lengthUnitPrm);
+  fMapBinningCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fSpectrumBinningCmd = new G4UIcommand("/testhadr/flux/spectrumBinning", this);
+  fSpectrumBinningCmd->SetGuidance("Binning of the energy spectra of all particles and faces.");
+  fSpectrumBinningCmd->SetGuidance("Books and activates them.");
+
+  auto nbinsSpecPrm = new G4UIparameter("nbins", 'i', false);
+  nbinsSpecPrm->SetParameterRange("nbins>0");
+  fSpectrumBinningCmd->SetParameter(nbinsSpecPrm);
+
+  auto eminPrm = new G4UIparameter("emin", 'd', false);
+  fSpectrumBinningCmd->SetParameter(eminPrm);
+
+  auto emaxPrm = new G4UIparameter("emax", 'd', false);
+  fSpectrumBinningCmd->SetParameter(emaxPrm);
+
+  auto energyUnitPrm = new G4UIparameter("unit", 's', true);
+  energyUnitPrm->SetDefaultValue("MeV");
+  energyUnitPrm->SetParameterCandidates(G4UIcommand::UnitsList("Energy"));
+  fSpectrumBinningCmd->SetParameter(energyUnitPrm);
+
+  auto schemePrm = new G4UIparameter("binScheme", 's', true);
+  schemePrm->SetDefaultValue("linear");
+  schemePrm->SetParameterCandidates("linear log");
+  fSpectrumBinningCmd->SetParameter(schemePrm);
+  fSpectrumBinningCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fLogSpectrumBinningCmd = new G4UIcommand("/testhadr/flux/logSpectrumBinning", this);
+  fLogSpectrumBinningCmd->SetGuidance("Logarithmic binning of the energy spectra of all particles");
+  fLogSpectrumBinningCmd->SetGuidance("and faces: binsPerOctave bins per factor 2, from the octave");
+  fLogSpectrumBinningCmd->SetGuidance("of emin to the one of emax. Books and activates them.");
+
+  auto octavePrm = new G4UIparameter("binsPerOctave", 'i', false);
+  octavePrm->SetParameterRange("binsPerOctave>0");
+  fLogSpectrumBinningCmd->SetParameter(octavePrm);
+
+  auto logEminPrm = new G4UIparameter("emin", 'd', false);
+  logEminPrm->SetParameterRange("emin>0.");
+  fLogSpectrumBinningCmd->SetParameter(logEminPrm);
+
+  auto logEmaxPrm = new G4UIparameter("emax", 'd', false);
+  logEmaxPrm->SetParameterRange("emax>0.");
+  fLogSpectrumBinningCmd->SetParameter(logEmaxPrm);
+
+  auto logUnitPrm = new G4UIparameter("unit", 's', true);
+  logUnitPrm->SetDefaultValue("MeV");
+  logUnitPrm->SetParameterCandidates(G4UIcommand::UnitsList("Energy"));
+  fLogSpectrumBinningCmd->SetParameter(logUnitPrm);
+  fLogSpectrumBinningCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fNormaliseCmd = new G4UIcmdWithABool("/testhadr/flux/normalise", this);
+  fNormaliseCmd->SetGuidance("Normalise the spectra per primary, and the maps per primary");
+  fNormaliseCmd->SetGuidance("and cm2 (fluence), at the end of the run.");
+  fNormaliseCmd->SetGuidance("Off by default: the histograms hold raw counts.");
+  fNormaliseCmd->SetParameterName("flag", true);
+  fNormaliseCmd->SetDefaultValue(true);
+  fNormaliseCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fSparseMapsCmd = new G4UIcmdWithABool("/testhadr/flux/sparseMaps", this);
+  fSparseMapsCmd->SetGuidance("Store only the filled bins of the fluence maps, written to");
+  fSparseMapsCmd->SetGuidance("the FluxMap_Sparse ntuple instead of the H2 0-59.");
+  fSparseMapsCmd->SetParameterName("flag", true);
+  fSparseMapsCmd->SetDefaultValue(true);
+  fSparseMapsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+HistoMessenger::~HistoMessenger()
+{
+  delete fMapBinningCmd;
+  delete fSpectrumBinningCmd;
+  delete fLogSpectrumBinningCmd;
+  delete fNormaliseCmd;
+  delete fSparseMapsCmd;
+  delete fFluxDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HistoMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if (command == fMapBinningCmd) {
+    G4int nbins;
+    G4double halfWidth;
+    G4String unit;
+    std::istringstream is(newValue);
+    is >> nbins >> halfWidth >> unit;
+    fHistoManager->SetMapBinning(nbins, halfWidth * G4UIcommand::ValueOf(unit), unit);
+  }
+
+  if (command == fSpectrumBinningCmd) {
+    G4int nbins;
+    G4double emin, emax;
+    G4String unit, binScheme;
+    std::istringstream is(newValue);
+    is >> nbins >> emin >> emax >> unit >> binScheme;
+    const G4double unitValue = G4UIcommand::ValueOf(unit);
+    if (emax <= emin || (binScheme == "log" && emin <= 0.)) {
+      G4cout << "\n --->warning from HistoMessenger : "
+             << "emax must be above emin, and emin above 0 for log. Command refused" << G4endl;
+      return;
+    }
+    fHistoManager->SetSpectrumBinning(nbins, emin * unitValue, emax * unitValue, unit, binScheme);
+  }
+
+  if (command == fLogSpectrumBinningCmd) {
+    G4int binsPerOctave;
+    G4double emin, emax;
+    G4String unit;
+    std::istringstream is(newValue);
+    is >> binsPerOctave >> emin >> emax >> unit;
+    if (emax <= emin) {
+      G4cout << "\n --->warning from HistoMessenger : "
+             << "emax must be above emin. Command refused" << G4endl;
+      return;
+    }
+    const G4double unitValue = G4UIcommand::ValueOf(unit);
+    fHistoManager->SetLogSpectrumBinning(binsPerOctave, emin * unitValue, emax * unitValue, unit);
+  }
+
+  if (command == fNormaliseCmd) {
+    fHistoManager->SetNormalisation(fNormaliseCmd->GetNewBoolValue(newValue));
+  }
+
+  if (command == fSparseMapsCmd) {
+    fHistoManager->SetSparseMaps(fSparseMapsCmd->GetNewBoolValue(newValue));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
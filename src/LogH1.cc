@@ -0,0 +1,151 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file LogH1.cc
+/// \brief Implementation of the LogH1 class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "LogH1.hh"
+
+#include <cmath>
+#include <istream>
+#include <ostream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+LogH1::LogH1(G4double xmin, G4double xmax, G4int binsPerOctave)
+  : fBinsPerOctave(binsPerOctave)
+{
+  // x = mantissa * 2^exponent, mantissa in [0.5, 1)
+  G4int maxExponent = 0;
+  std::frexp(xmin, &fMinExponent);
+  std::frexp(xmax, &maxExponent);
+  fNbOctaves = maxExponent - fMinExponent + 1;
+
+  const std::size_t size = GetNbins() + 2;
+  fEntries.assign(size, 0.);
+  fSumW.assign(size, 0.);
+  fSumW2.assign(size, 0.);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void LogH1::Fill(G4double x, G4double weight)
+{
+  G4int exponent = 0;
+  const G4double mantissa = std::frexp(x, &exponent);
+  const G4int octave = exponent - fMinExponent;
+
+  G4int bin = 0;
+  if (x > 0. && octave >= fNbOctaves) {
+    bin = GetNbins() + 1;
+  }
+  else if (x > 0. && octave >= 0) {
+    bin = 1 + octave * fBinsPerOctave + G4int((2. * mantissa - 1.) * fBinsPerOctave);
+  }
+
+  fEntries[bin] += 1.;
+  fSumW[bin] += weight;
+  fSumW2[bin] += weight * weight;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void LogH1::Merge(const LogH1& other)
+{
+  for (std::size_t bin = 0; bin < fSumW.size(); ++bin) {
+    fEntries[bin] += other.fEntries[bin];
+    fSumW[bin] += other.fSumW[bin];
+    fSumW2[bin] += other.fSumW2[bin];
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void LogH1::Reset()
+{
+  fEntries.assign(fEntries.size(), 0.);
+  fSumW.assign(fSumW.size(), 0.);
+  fSumW2.assign(fSumW2.size(), 0.);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void LogH1::Save(std::ostream& os) const
+{
+  os << fMinExponent << ' ' << fNbOctaves << ' ' << fBinsPerOctave << '\n';
+  for (std::size_t bin = 0; bin < fSumW.size(); ++bin) {
+    if (fEntries[bin] == 0.) continue;
+    os << bin << ' ' << fEntries[bin] << ' ' << fSumW[bin] << ' ' << fSumW2[bin] << '\n';
+  }
+  os << "-1\n";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool LogH1::Restore(std::istream& is)
+{
+  if (!(is >> fMinExponent >> fNbOctaves >> fBinsPerOctave) || fBinsPerOctave <= 0) return false;
+  const std::size_t size = GetNbins() + 2;
+  fEntries.assign(size, 0.);
+  fSumW.assign(size, 0.);
+  fSumW2.assign(size, 0.);
+
+  G4long bin = 0;
+  while (is >> bin && bin >= 0) {
+    if (bin >= (G4long)size) return false;
+    is >> fEntries[bin] >> fSumW[bin] >> fSumW2[bin];
+  }
+  return !is.fail();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<G4double> LogH1::GetEdges() const
+{
+  std::vector<G4double> edges;
+  edges.reserve(GetNbins() + 1);
+  for (G4int octave = 0; octave < fNbOctaves; ++octave) {
+    for (G4int k = 0; k < fBinsPerOctave; ++k) {
+      edges.push_back(std::ldexp(1. + G4double(k) / fBinsPerOctave, fMinExponent - 1 + octave));
+    }
+  }
+  edges.push_back(std::ldexp(1., fMinExponent - 1 + fNbOctaves));
+  return edges;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double LogH1::GetBinCenter(G4int bin) const
+{
+  const G4int octave = (bin - 1) / fBinsPerOctave;
+  const G4int k = (bin - 1) % fBinsPerOctave;
+  return std::ldexp(1. + (k + 0.5) / fBinsPerOctave, fMinExponent - 1 + octave);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,259 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file NeutronKiller.cc
+/// \brief Implementation of the NeutronKiller class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NeutronKiller.hh"
+
+#include "Run.hh"
+
+#include "G4AutoLock.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Neutron.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4RunManager.hh"
+#include "G4Step.hh"
+#include "G4UnitsTable.hh"
+#include "G4VPhysicalVolume.hh"
+
+#include <atomic>
+#include <cmath>
+#include <map>
+
+namespace
+{
+G4Mutex settingsMutex = G4MUTEX_INITIALIZER;
+std::map<G4String, NeutronKiller::Limits> sharedLimits;  // by region name, kUnset fields
+G4ThreeVector sharedEnvelope;
+G4ThreeVector sharedCentre;  // of the envelope, set by the geometry
+// bumped at every change, the instances copy the settings when it moves
+std::atomic<G4int> sharedVersion{0};
+
+const char* const kDefaultRegion = "all";
+// a limit not given for a region, the one of "all" applies
+const G4double kUnset = -1.;
+
+NeutronKiller::Limits& SharedLimits(const G4String& region)
+{
+  return sharedLimits.try_emplace(region, NeutronKiller::Limits{kUnset, kUnset}).first->second;
+}
+
+// Limits of a region given the default ones, field by field
+NeutronKiller::Limits Resolve(const NeutronKiller::Limits& limits,
+                              const NeutronKiller::Limits& defaults)
+{
+  NeutronKiller::Limits resolved = defaults;
+  if (limits.fEnergy != kUnset) resolved.fEnergy = limits.fEnergy;
+  if (limits.fTime != kUnset) resolved.fTime = limits.fTime;
+  return resolved;
+}
+}  // namespace
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NeutronKiller::NeutronKiller(const G4String& name) : G4VDiscreteProcess(name, fGeneral) {}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool NeutronKiller::IsApplicable(const G4ParticleDefinition& particle)
+{
+  return &particle == G4Neutron::Neutron();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NeutronKiller::StartTracking(G4Track* track)
+{
+  G4VDiscreteProcess::StartTracking(track);
+  if (fVersion != sharedVersion.load(std::memory_order_acquire)) Update();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NeutronKiller::Update()
+{
+  G4AutoLock lock(&settingsMutex);
+  fVersion = sharedVersion.load(std::memory_order_relaxed);
+  fDefaultLimits = Limits();
+  auto defaultLimits = sharedLimits.find(kDefaultRegion);
+  if (defaultLimits != sharedLimits.end())
+    fDefaultLimits = Resolve(defaultLimits->second, Limits());
+  fRegionLimits.clear();
+  for (const auto& [name, limits] : sharedLimits) {
+    if (name == kDefaultRegion) continue;
+    const G4Region* region = G4RegionStore::GetInstance()->GetRegion(name, false);
+    if (region == nullptr) {
+      G4cout << "\n --->warning from NeutronKiller: no region named " << name
+             << ", its limits are ignored" << G4endl;
+      continue;
+    }
+    fRegionLimits.emplace_back(region, Resolve(limits, fDefaultLimits));
+  }
+  fEnvelope = sharedEnvelope;
+  fCentre = sharedCentre;
+
+  fActive = fDefaultLimits.fEnergy > 0. || fDefaultLimits.fTime < DBL_MAX
+            || !fRegionLimits.empty() || fEnvelope.x() > 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NeutronKiller::Reason NeutronKiller::ReasonToKill(const G4Track& track) const
+{
+  const Limits* limits = &fDefaultLimits;
+  if (!fRegionLimits.empty()) {
+    const G4Region* region = track.GetVolume()->GetLogicalVolume()->GetRegion();
+    for (const auto& regionLimits : fRegionLimits) {
+      if (regionLimits.first == region) {
+        limits = &regionLimits.second;
+        break;
+      }
+    }
+  }
+  if (track.GetKineticEnergy() < limits->fEnergy) return kEnergy;
+  if (track.GetGlobalTime() > limits->fTime) return kTime;
+
+  if (fEnvelope.x() > 0.) {
+    // a straight line misses the box if, along one axis, the track is
+    // outside and not coming back
+    const G4ThreeVector position = track.GetPosition() - fCentre;
+    const G4ThreeVector& direction = track.GetMomentumDirection();
+    for (G4int i = 0; i < 3; ++i) {
+      if (std::abs(position[i]) > fEnvelope[i] && position[i] * direction[i] >= 0.)
+        return kEnvelope;
+    }
+  }
+  return kNbReasons;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double NeutronKiller::PostStepGetPhysicalInteractionLength(const G4Track& track, G4double,
+                                                             G4ForceCondition* condition)
+{
+  *condition = NotForced;
+  if (!fActive) return DBL_MAX;
+  fReason = ReasonToKill(track);
+  return (fReason != kNbReasons) ? 0. : DBL_MAX;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4VParticleChange* NeutronKiller::PostStepDoIt(const G4Track& track, const G4Step&)
+{
+  Run* run = static_cast<Run*>(G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+  run->CountNeutronKill(fReason, track.GetKineticEnergy());
+
+  aParticleChange.Initialize(track);
+  aParticleChange.ProposeTrackStatus(fStopAndKill);
+  return &aParticleChange;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const char* NeutronKiller::GetReasonName(G4int reason)
+{
+  static const char* const names[kNbReasons] = {"energy", "time", "envelope"};
+  return (reason >= 0 && reason < kNbReasons) ? names[reason] : "";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NeutronKiller::SetEnergyLimit(const G4String& region, G4double energy)
+{
+  G4AutoLock lock(&settingsMutex);
+  SharedLimits(region).fEnergy = energy;
+  sharedVersion++;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NeutronKiller::SetTimeLimit(const G4String& region, G4double time)
+{
+  G4AutoLock lock(&settingsMutex);
+  SharedLimits(region).fTime = (time > 0.) ? time : DBL_MAX;
+  sharedVersion++;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NeutronKiller::SetEnvelope(const G4ThreeVector& halfLengths)
+{
+  G4AutoLock lock(&settingsMutex);
+  // one zero length disables the envelope
+  const G4bool enabled = halfLengths.x() > 0. && halfLengths.y() > 0. && halfLengths.z() > 0.;
+  sharedEnvelope = enabled ? halfLengths : G4ThreeVector();
+  sharedVersion++;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NeutronKiller::SetEnvelopeCentre(const G4ThreeVector& centre)
+{
+  G4AutoLock lock(&settingsMutex);
+  sharedCentre = centre;
+  sharedVersion++;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NeutronKiller::PrintSettings()
+{
+  G4AutoLock lock(&settingsMutex);
+  G4cout << "\n Neutron killer (nKiller):";
+  if (sharedLimits.empty() && sharedEnvelope.x() <= 0.) G4cout << " off";
+  for (const auto& [name, regionLimits] : sharedLimits) {
+    const Limits limits =
+      (name == kDefaultRegion) ? Resolve(regionLimits, Limits()) : regionLimits;
+    G4cout << "\n   region " << name << " : ";
+    if (limits.fEnergy == kUnset)
+      G4cout << "energy limit of all";
+    else if (limits.fEnergy > 0.)
+      G4cout << "E < " << G4BestUnit(limits.fEnergy, "Energy");
+    else
+      G4cout << "no energy limit";
+    if (limits.fTime == kUnset)
+      G4cout << ", time limit of all";
+    else if (limits.fTime < DBL_MAX)
+      G4cout << ", t > " << G4BestUnit(limits.fTime, "Time");
+    else
+      G4cout << ", no time limit";
+  }
+  if (sharedEnvelope.x() > 0.) {
+    G4cout << "\n   outside the envelope |x| < " << G4BestUnit(sharedEnvelope.x(), "Length")
+           << " |y| < " << G4BestUnit(sharedEnvelope.y(), "Length")
+           << " |z| < " << G4BestUnit(sharedEnvelope.z(), "Length") << " around x = "
+           << G4BestUnit(sharedCentre.x(), "Length") << " and moving away";
+  }
+  G4cout << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
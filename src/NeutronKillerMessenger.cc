@@ -0,0 +1,135 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file NeutronKillerMessenger.cc
+/// \brief Implementation of the NeutronKillerMessenger class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NeutronKillerMessenger.hh"
+
+#include "NeutronKiller.hh"
+
+#include "G4UIcmdWith3VectorAndUnit.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+
+#include <sstream>
+
+namespace
+{
+// region, value, unit of the given category
+G4UIcommand* NewLimitCommand(const char* path, G4UImessenger* messenger, const char* category,
+                             const char* defaultUnit)
+{
+  auto command = new G4UIcommand(path, messenger);
+
+  auto regionPrm = new G4UIparameter("region", 's', false);
+  regionPrm->SetGuidance("region name, all for the regions without their own limits");
+  command->SetParameter(regionPrm);
+
+  auto valuePrm = new G4UIparameter("value", 'd', false);
+  valuePrm->SetGuidance("limit, 0 disables");
+  valuePrm->SetParameterRange("value>=0.");
+  command->SetParameter(valuePrm);
+
+  auto unitPrm = new G4UIparameter("unit", 's', false);
+  unitPrm->SetGuidance("unit of value");
+  unitPrm->SetDefaultValue(defaultUnit);
+  unitPrm->SetParameterCandidates(G4UIcommand::UnitsList(category));
+  command->SetParameter(unitPrm);
+
+  command->AvailableForStates(G4State_PreInit, G4State_Idle);
+  command->SetToBeBroadcasted(false);
+  return command;
+}
+}  // namespace
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NeutronKillerMessenger::NeutronKillerMessenger()
+{
+  fEnergyCmd = NewLimitCommand("/testhadr/phys/killNeutronEnergy", this, "Energy", "eV");
+  fEnergyCmd->SetGuidance("Kill the neutrons below a kinetic energy in a region.");
+
+  fTimeCmd = NewLimitCommand("/testhadr/phys/killNeutronTime", this, "Time", "ms");
+  fTimeCmd->SetGuidance("Kill the neutrons after a global time in a region.");
+
+  fEnvelopeCmd = new G4UIcmdWith3VectorAndUnit("/testhadr/phys/killNeutronEnvelope", this);
+  fEnvelopeCmd->SetGuidance("Kill the neutrons outside a box centred on the slab stack");
+  fEnvelopeCmd->SetGuidance("and moving away from it. Half lengths, 0 disables.");
+  fEnvelopeCmd->SetGuidance("The box should contain the silicon slabs when they are built.");
+  fEnvelopeCmd->SetParameterName("halfX", "halfY", "halfZ", false);
+  fEnvelopeCmd->SetRange("halfX>=0. && halfY>=0. && halfZ>=0.");
+  fEnvelopeCmd->SetUnitCategory("Length");
+  fEnvelopeCmd->SetDefaultUnit("cm");
+  fEnvelopeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fEnvelopeCmd->SetToBeBroadcasted(false);
+
+  fPrintCmd = new G4UIcmdWithoutParameter("/testhadr/phys/printNeutronKiller", this);
+  fPrintCmd->SetGuidance("Print the neutron killer settings.");
+  fPrintCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fPrintCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NeutronKillerMessenger::~NeutronKillerMessenger()
+{
+  delete fEnergyCmd;
+  delete fTimeCmd;
+  delete fEnvelopeCmd;
+  delete fPrintCmd;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NeutronKillerMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if (command == fEnergyCmd || command == fTimeCmd) {
+    G4String region, unit;
+    G4double value;
+    std::istringstream is(newValue);
+    is >> region >> value >> unit;
+    value *= G4UIcommand::ValueOf(unit);
+    if (command == fEnergyCmd)
+      NeutronKiller::SetEnergyLimit(region, value);
+    else
+      NeutronKiller::SetTimeLimit(region, value);
+  }
+
+  if (command == fEnvelopeCmd) {
+    NeutronKiller::SetEnvelope(fEnvelopeCmd->GetNew3VectorValue(newValue));
+  }
+
+  if (command == fPrintCmd) {
+    NeutronKiller::PrintSettings();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
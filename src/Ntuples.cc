@@ -0,0 +1,66 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file Ntuples.cc
+/// \brief Implementation of the Ntuples class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "Ntuples.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Ntuples* Ntuples::Instance()
+{
+  static G4ThreadLocal Ntuples* instance = nullptr;
+  if (instance == nullptr) instance = new Ntuples();
+  return instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Ntuples::Book()
+{
+  // The booking order gives the ntuple ids 0-6 used by the analysis macros,
+  // new ntuples go at the end
+  fNeutronCapture.Book("NeutronCapture_Data", "NeutronCapture_Data");
+  fBoronEdep.Book("BoronEdep", "BoronEdep");
+  fSiliconEdep[0].Book("SiliconEdep_Y_1", "SiliconEdep_Y_1");
+  fSiliconEdep[1].Book("SiliconEdep_Y_2", "SiliconEdep_Y_2");
+  fSiliconEdep[2].Book("SiliconEdep_Z_1", "SiliconEdep_Z_1");
+  fSiliconEdep[3].Book("SiliconEdep_Z_2", "SiliconEdep_Z_2");
+  fExitWorld.Book("Particles_Exit_World", "Particles_Exit_World");
+  fSiliconSegment[0].Book("SiliconSegment_Y_1", "SiliconSegment_Y_1");
+  fSiliconSegment[1].Book("SiliconSegment_Y_2", "SiliconSegment_Y_2");
+  fSiliconSegment[2].Book("SiliconSegment_Z_1", "SiliconSegment_Z_1");
+  fSiliconSegment[3].Book("SiliconSegment_Z_2", "SiliconSegment_Z_2");
+  fTrackSummary.Book("Track_Summary", "Track_Summary");
+  fDoseSummary.Book("Dose_Summary", "Dose_Summary");
+  fSparseMap.Book("FluxMap_Sparse", "FluxMap_Sparse");
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,132 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ParticleClassifier.cc
+/// \brief Implementation of the ParticleClassifier class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "ParticleClassifier.hh"
+
+#include "G4AutoLock.hh"
+#include "G4ParticleTable.hh"
+#include "G4ParticleTypes.hh"
+
+#include <map>
+#include <vector>
+
+namespace
+{
+G4Mutex registryMutex = G4MUTEX_INITIALIZER;
+std::map<const G4ParticleDefinition*, G4int> registryIndices;
+std::vector<const G4ParticleDefinition*> registryParticles;
+}  // namespace
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ParticleClassifier* ParticleClassifier::Instance()
+{
+  static G4ThreadLocal ParticleClassifier* instance = nullptr;
+  if (instance == nullptr) instance = new ParticleClassifier();
+  return instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ParticleClassifier::ParticleClassifier()
+{
+  G4ParticleTable::G4PTblDicIterator* particleIterator =
+    G4ParticleTable::GetParticleTable()->GetIterator();
+  particleIterator->reset();
+  while ((*particleIterator)()) {
+    Add(particleIterator->value());
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const ParticleClassifier::ParticleInfo&
+ParticleClassifier::Add(const G4ParticleDefinition* particle)
+{
+  ParticleInfo& info = fTable[particle];
+  info.fCategory = Compute(particle);
+  info.fIndex = Register(particle);
+  return info;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int ParticleClassifier::Register(const G4ParticleDefinition* particle)
+{
+  // The definitions, ions included, are shared by all threads
+  G4AutoLock lock(&registryMutex);
+  auto it = registryIndices.find(particle);
+  if (it != registryIndices.end()) return it->second;
+  G4int index = (G4int)registryParticles.size();
+  registryIndices[particle] = index;
+  registryParticles.push_back(particle);
+  return index;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const G4ParticleDefinition* ParticleClassifier::GetParticle(G4int index)
+{
+  G4AutoLock lock(&registryMutex);
+  return (index >= 0 && index < (G4int)registryParticles.size()) ? registryParticles[index]
+                                                                  : nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int ParticleClassifier::GetNbIndices()
+{
+  G4AutoLock lock(&registryMutex);
+  return (G4int)registryParticles.size();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ParticleClassifier::Category ParticleClassifier::Compute(const G4ParticleDefinition* particle)
+{
+  if (particle->GetPDGCharge() > 3.) return kOtherIon;
+  if (particle == G4Gamma::Gamma()) return kGamma;
+  if (particle == G4Electron::Electron() || particle == G4Positron::Positron()) return kElectron;
+  if (particle == G4Neutron::Neutron()) return kNeutron;
+  if (particle == G4Proton::Proton()) return kProton;
+  if (particle == G4Deuteron::Deuteron()) return kDeuteron;
+  if (particle == G4Alpha::Alpha()) return kAlpha;
+
+  const G4String& type = particle->GetParticleType();
+  if (type == "nucleus") return kOtherIon;
+  if (type == "baryon") return kOtherBaryon;
+  if (type == "meson") return kOtherMeson;
+  if (type == "lepton") return kOtherLepton;
+  return kUnclassified;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -35,6 +35,9 @@
 #include "GammaNuclearPhysics.hh"
 #include "GammaNuclearPhysicsLEND.hh"
 #include "HadronElasticPhysicsHP.hh"
+#include "NeutronKiller.hh"
+#include "NeutronKillerMessenger.hh"
+#include "ProcessClassifier.hh"
 #include "RadioactiveDecayPhysics.hh"
 
 #include "G4DecayPhysics.hh"
@@ -119,6 +122,16 @@ PhysicsList::PhysicsList()
   fRadioactiveDecay = new RadioactiveDecayPhysics();
   ////fRadioactiveDecay = new G4RadioactiveDecayPhysics();
   RegisterPhysics(fRadioactiveDecay);
+
+  // /testhadr/phys/ commands of the neutron killer
+  fNeutronKillerMessenger = new NeutronKillerMessenger();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhysicsList::~PhysicsList()
+{
+  delete fNeutronKillerMessenger;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -146,6 +159,15 @@ void PhysicsList::ConstructProcess()
   G4HadronicProcess* process = dynamic_cast<G4HadronicProcess*>(pManager->GetProcess("nCapture"));
   G4HadronicInteraction* model = process->GetHadronicModel("nRadCapture");
   if (model) model->SetMinEnergy(19.9 * MeV);
+
+  // kills the neutrons which can no longer reach a detector, off until
+  // limits are set (/testhadr/phys/killNeutron...)
+  //
+  pManager->AddDiscreteProcess(new NeutronKiller());
+
+  // dense process codes for the per-run process counters
+  //
+  ProcessClassifier::RegisterProcesses();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
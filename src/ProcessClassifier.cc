@@ -0,0 +1,130 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ProcessClassifier.cc
+/// \brief Implementation of the ProcessClassifier class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "ProcessClassifier.hh"
+
+#include "G4AutoLock.hh"
+#include "G4HadronicProcess.hh"
+#include "G4ParticleTable.hh"
+#include "G4ProcessManager.hh"
+#include "G4ProcessVector.hh"
+#include "G4VProcess.hh"
+
+#include <map>
+#include <vector>
+
+namespace
+{
+G4Mutex registryMutex = G4MUTEX_INITIALIZER;
+std::map<G4String, G4int> registryCodes;
+std::vector<G4String> registryNames;
+}  // namespace
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ProcessClassifier* ProcessClassifier::Instance()
+{
+  static G4ThreadLocal ProcessClassifier* instance = nullptr;
+  if (instance == nullptr) instance = new ProcessClassifier();
+  return instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const ProcessInfo& ProcessClassifier::Add(const G4VProcess* process)
+{
+  ProcessInfo& info = fTable[process];
+  info.fCode = Register(process->GetProcessName());
+  info.fCategory = process->GetProcessType();
+  info.fSubType = process->GetProcessSubType();
+  info.fIsHadronic = (info.fCategory == fHadronic);
+  // GetTargetIsotope() is not const in G4HadronicProcess
+  info.fHadronic = dynamic_cast<G4HadronicProcess*>(const_cast<G4VProcess*>(process));
+  return info;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int ProcessClassifier::Register(const G4String& name)
+{
+  G4AutoLock lock(&registryMutex);
+  auto it = registryCodes.find(name);
+  if (it != registryCodes.end()) return it->second;
+  G4int code = (G4int)registryNames.size();
+  registryCodes[name] = code;
+  registryNames.push_back(name);
+  return code;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int ProcessClassifier::FindCode(const G4String& name)
+{
+  G4AutoLock lock(&registryMutex);
+  auto it = registryCodes.find(name);
+  return (it != registryCodes.end()) ? it->second : -1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ProcessClassifier::RegisterProcesses()
+{
+  G4ParticleTable::G4PTblDicIterator* particleIterator =
+    G4ParticleTable::GetParticleTable()->GetIterator();
+  particleIterator->reset();
+  while ((*particleIterator)()) {
+    G4ProcessManager* pManager = particleIterator->value()->GetProcessManager();
+    if (pManager == nullptr) continue;
+    G4ProcessVector* processes = pManager->GetProcessList();
+    for (std::size_t i = 0; i < processes->size(); ++i) {
+      Register((*processes)[i]->GetProcessName());
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String ProcessClassifier::GetName(G4int code)
+{
+  G4AutoLock lock(&registryMutex);
+  return (code >= 0 && code < (G4int)registryNames.size()) ? registryNames[code] : "";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int ProcessClassifier::GetNbCodes()
+{
+  G4AutoLock lock(&registryMutex);
+  return (G4int)registryNames.size();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
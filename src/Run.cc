@@ -34,14 +34,37 @@
 
 #include "DetectorConstruction.hh"
 #include "HistoManager.hh"
+#include "ParticleClassifier.hh"
 #include "PrimaryGeneratorAction.hh"
+#include "ProcessClassifier.hh"
+#include "StackingAction.hh"
 
+#include "ScoringSD.hh"
+
+#include "G4IonTable.hh"
+#include "G4LogicalVolume.hh"
+#include "G4ParticleTable.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4UnitsTable.hh"
 
+#include <istream>
+#include <ostream>
+
+namespace
+{
+// Reads the label of a section of a checkpoint
+G4bool ExpectLabel(std::istream& is, const char* label)
+{
+  G4String word;
+  return (is >> word) && word == label;
+}
+}  // namespace
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-Run::Run(DetectorConstruction* det) : fDetector(det) {}
+Run::Run(DetectorConstruction* det)
+  : fDetector(det), fProcCounter(ProcessClassifier::GetNbCodes(), 0)
+{}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -53,39 +76,55 @@ void Run::SetPrimary(G4ParticleDefinition* particle, G4double energy)
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void Run::CountProcesses(const G4VProcess* process)
+void Run::CountProcesses(G4int processCode)
 {
-  if (process == nullptr) return;
-  G4String procName = process->GetProcessName();
-  std::map<G4String, G4int>::iterator it = fProcCounter.find(procName);
-  if (it == fProcCounter.end()) {
-    fProcCounter[procName] = 1;
-  }
-  else {
-    fProcCounter[procName]++;
+  if (processCode < 0) return;
+  // only processes registered after the physics construction grow the array
+  if (processCode >= (G4int)fProcCounter.size()) fProcCounter.resize(processCode + 1, 0);
+  fProcCounter[processCode]++;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::CountStackingRule(G4int ruleId, G4double energy)
+{
+  if (ruleId >= (G4int)fStackingCounter.size()) {
+    fStackingCounter.resize(ruleId + 1, 0);
+    fStackingEnergy.resize(ruleId + 1, 0.);
   }
+  fStackingCounter[ruleId]++;
+  fStackingEnergy[ruleId] += energy;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::CountNeutronKill(G4int reason, G4double energy)
+{
+  fNeutronKills[reason]++;
+  fNeutronKillEnergy[reason] += energy;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void Run::ParticleCount(G4String name, G4double Ekin, G4double meanLife)
+#ifdef NEUTRONSOURCE_COUNT_ALLOCATIONS
+void Run::CountStepAllocations(G4bool recorded, std::uint64_t allocations)
 {
-  std::map<G4String, ParticleData>::iterator it = fParticleDataMap1.find(name);
-  if (it == fParticleDataMap1.end()) {
-    fParticleDataMap1[name] = ParticleData(1, Ekin, Ekin, Ekin, meanLife);
-  }
-  else {
-    ParticleData& data = it->second;
-    data.fCount++;
-    data.fEmean += Ekin;
-    // update min max
-    G4double emin = data.fEmin;
-    if (Ekin < emin) data.fEmin = Ekin;
-    G4double emax = data.fEmax;
-    if (Ekin > emax) data.fEmax = Ekin;
-    data.fTmean = meanLife;
+  if (recorded) return;
+  fUnrecordedSteps++;
+  if (allocations > 0) {
+    fUnrecordedStepsAllocating++;
+    fUnrecordedStepAllocations += allocations;
   }
 }
+#endif
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::ParticleCount(const G4ParticleDefinition* particle, G4double Ekin, G4double meanLife,
+                        G4double weight)
+{
+  GetParticleData(fCreatedParticles, particle).Add(Ekin, meanLife, weight);
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -104,22 +143,78 @@ void Run::AddEflow(G4double eflow)
 }
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void Run::ParticleFlux(G4String name, G4double Ekin)
+void Run::FillSpectrum(G4int h1, G4double energy, G4double weight)
+{
+  if (fSpectra.empty()) {
+    const G4int nbSpectra = HistoManager::kFirstFaceSpectrum + HistoManager::kNbMaps
+                            - HistoManager::kFirstSpectrum;
+    fSpectra.assign(nbSpectra, HistoManager::Instance()->NewLogSpectrum());
+  }
+  fSpectra[h1 - HistoManager::kFirstSpectrum].Fill(energy, weight);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::FillFluxMap(G4int map, G4double u, G4double v, G4double weight)
+{
+  // most runs never fill them
+  if (fFluxMaps.empty()) {
+    fFluxMaps.assign(HistoManager::kNbMaps, HistoManager::Instance()->NewSparseMap());
+  }
+  fFluxMaps[map].Fill(u, v, weight);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::ParticleFlux(const G4ParticleDefinition* particle, G4double Ekin, G4double weight)
+{
+  GetParticleData(fEmergingParticles, particle).Add(Ekin, -1 * ns, weight);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Run::ParticleData& Run::GetParticleData(std::vector<ParticleData>& table,
+                                        const G4ParticleDefinition* particle)
+{
+  const G4int index = ParticleClassifier::Instance()->GetInfo(particle).fIndex;
+  if (index >= (G4int)table.size()) table.resize(index + 1);
+  return table[index];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::ParticleData::Add(G4double ekin, G4double meanLife, G4double weight)
+{
+  if (fCount == 0 || ekin < fEmin) fEmin = ekin;
+  if (fCount == 0 || ekin > fEmax) fEmax = ekin;
+  fCount++;
+  fSumW += weight;
+  fEmean += weight * ekin;
+  fTmean = meanLife;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::ParticleData::Merge(const ParticleData& other)
+{
+  if (other.fCount == 0) return;
+  if (fCount == 0 || other.fEmin < fEmin) fEmin = other.fEmin;
+  if (fCount == 0 || other.fEmax > fEmax) fEmax = other.fEmax;
+  fCount += other.fCount;
+  fSumW += other.fSumW;
+  fEmean += other.fEmean;
+  fTmean = other.fTmean;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::MergeParticleData(std::vector<ParticleData>& table,
+                            const std::vector<ParticleData>& localTable)
 {
-  std::map<G4String, ParticleData>::iterator it = fParticleDataMap2.find(name);
-  if (it == fParticleDataMap2.end()) {
-    fParticleDataMap2[name] = ParticleData(1, Ekin, Ekin, Ekin, -1 * ns);
-  }
-  else {
-    ParticleData& data = it->second;
-    data.fCount++;
-    data.fEmean += Ekin;
-    // update min max
-    G4double emin = data.fEmin;
-    if (Ekin < emin) data.fEmin = Ekin;
-    G4double emax = data.fEmax;
-    if (Ekin > emax) data.fEmax = Ekin;
-    data.fTmean = -1 * ns;
+  // the indices are the same on all threads
+  if (localTable.size() > table.size()) table.resize(localTable.size());
+  for (std::size_t index = 0; index < localTable.size(); ++index) {
+    table[index].Merge(localTable[index]);
   }
 }
 
@@ -140,59 +235,73 @@ void Run::Merge(const G4Run* run)
   fEnergyDeposit2 += localRun->fEnergyDeposit2;
   fEnergyFlow += localRun->fEnergyFlow;
   fEnergyFlow2 += localRun->fEnergyFlow2;
+#ifdef NEUTRONSOURCE_COUNT_ALLOCATIONS
+  fUnrecordedSteps += localRun->fUnrecordedSteps;
+  fUnrecordedStepsAllocating += localRun->fUnrecordedStepsAllocating;
+  fUnrecordedStepAllocations += localRun->fUnrecordedStepAllocations;
+#endif
+#ifdef NEUTRONSOURCE_PROFILE_STEPPING
+  fStepProfile.Merge(localRun->fStepProfile);
+#endif
+
+  // processes count, the codes are the same on all threads
+  const std::vector<std::uint64_t>& localProcCounter = localRun->fProcCounter;
+  if (localProcCounter.size() > fProcCounter.size())
+    fProcCounter.resize(localProcCounter.size(), 0);
+  for (std::size_t code = 0; code < localProcCounter.size(); ++code) {
+    fProcCounter[code] += localProcCounter[code];
+  }
 
-  // map: processes count
-  std::map<G4String, G4int>::const_iterator itp;
-  for (itp = localRun->fProcCounter.begin(); itp != localRun->fProcCounter.end(); ++itp) {
-    G4String procName = itp->first;
-    G4int localCount = itp->second;
-    if (fProcCounter.find(procName) == fProcCounter.end()) {
-      fProcCounter[procName] = localCount;
-    }
-    else {
-      fProcCounter[procName] += localCount;
-    }
+  // stacking rules, the ids are the same on all threads
+  const std::vector<std::uint64_t>& localStackingCounter = localRun->fStackingCounter;
+  if (localStackingCounter.size() > fStackingCounter.size()) {
+    fStackingCounter.resize(localStackingCounter.size(), 0);
+    fStackingEnergy.resize(localStackingCounter.size(), 0.);
+  }
+  for (std::size_t id = 0; id < localStackingCounter.size(); ++id) {
+    fStackingCounter[id] += localStackingCounter[id];
+    fStackingEnergy[id] += localRun->fStackingEnergy[id];
   }
 
-  // map: created particles count
-  std::map<G4String, ParticleData>::const_iterator itc;
-  for (itc = localRun->fParticleDataMap1.begin(); itc != localRun->fParticleDataMap1.end(); ++itc) {
-    G4String name = itc->first;
-    const ParticleData& localData = itc->second;
-    if (fParticleDataMap1.find(name) == fParticleDataMap1.end()) {
-      fParticleDataMap1[name] = ParticleData(localData.fCount, localData.fEmean, localData.fEmin,
-                                             localData.fEmax, localData.fTmean);
-    }
-    else {
-      ParticleData& data = fParticleDataMap1[name];
-      data.fCount += localData.fCount;
-      data.fEmean += localData.fEmean;
-      G4double emin = localData.fEmin;
-      if (emin < data.fEmin) data.fEmin = emin;
-      G4double emax = localData.fEmax;
-      if (emax > data.fEmax) data.fEmax = emax;
-      data.fTmean = localData.fTmean;
+  // neutrons killed by the neutron killer
+  for (G4int reason = 0; reason < NeutronKiller::kNbReasons; ++reason) {
+    fNeutronKills[reason] += localRun->fNeutronKills[reason];
+    fNeutronKillEnergy[reason] += localRun->fNeutronKillEnergy[reason];
+  }
+
+  // created and emerging particles
+  MergeParticleData(fCreatedParticles, localRun->fCreatedParticles);
+  MergeParticleData(fEmergingParticles, localRun->fEmergingParticles);
+
+  // tally of /run/beamOnUntil
+  fTally.Merge(localRun->fTally);
+
+  // energy deposits for the dose
+  for (G4int v = 0; v < kNbScoringVolumes; ++v) {
+    for (G4int c = 0; c < DoseSummaryRow::kNbClasses; ++c) {
+      fDoseEdep[v][c] += localRun->fDoseEdep[v][c];
     }
   }
 
-  // map: particles flux count
-  std::map<G4String, ParticleData>::const_iterator itn;
-  for (itn = localRun->fParticleDataMap2.begin(); itn != localRun->fParticleDataMap2.end(); ++itn) {
-    G4String name = itn->first;
-    const ParticleData& localData = itn->second;
-    if (fParticleDataMap2.find(name) == fParticleDataMap2.end()) {
-      fParticleDataMap2[name] = ParticleData(localData.fCount, localData.fEmean, localData.fEmin,
-                                             localData.fEmax, localData.fTmean);
+  // log spectra
+  const std::vector<LogH1>& localSpectra = localRun->fSpectra;
+  if (fSpectra.empty()) {
+    fSpectra = localSpectra;
+  }
+  else if (!localSpectra.empty()) {
+    for (std::size_t i = 0; i < fSpectra.size(); ++i) {
+      fSpectra[i].Merge(localSpectra[i]);
     }
-    else {
-      ParticleData& data = fParticleDataMap2[name];
-      data.fCount += localData.fCount;
-      data.fEmean += localData.fEmean;
-      G4double emin = localData.fEmin;
-      if (emin < data.fEmin) data.fEmin = emin;
-      G4double emax = localData.fEmax;
-      if (emax > data.fEmax) data.fEmax = emax;
-      data.fTmean = localData.fTmean;
+  }
+
+  // sparse fluence maps
+  const std::vector<SparseH2>& localMaps = localRun->fFluxMaps;
+  if (fFluxMaps.empty()) {
+    fFluxMaps = localMaps;
+  }
+  else if (!localMaps.empty()) {
+    for (std::size_t ih = 0; ih < fFluxMaps.size(); ++ih) {
+      fFluxMaps[ih].Merge(localMaps[ih]);
     }
   }
 
@@ -223,11 +332,16 @@ void Run::EndOfRun()
   // frequency of processes
   //
   G4cout << "\n Process calls frequency :" << G4endl;
+  std::map<G4String, std::uint64_t> procCounts;  // by name, for the printout order
+  for (std::size_t code = 0; code < fProcCounter.size(); ++code) {
+    if (fProcCounter[code] == 0) continue;
+    procCounts[ProcessClassifier::GetName((G4int)code)] = fProcCounter[code];
+  }
   G4int index = 0;
-  std::map<G4String, G4int>::iterator it;
-  for (it = fProcCounter.begin(); it != fProcCounter.end(); it++) {
+  std::map<G4String, std::uint64_t>::iterator it;
+  for (it = procCounts.begin(); it != procCounts.end(); it++) {
     G4String procName = it->first;
-    G4int count = it->second;
+    std::uint64_t count = it->second;
     G4String space = " ";
     if (++index % 3 == 0) space = "\n";
     G4cout << " " << std::setw(20) << procName << "=" << std::setw(7) << count << space;
@@ -238,24 +352,7 @@ void Run::EndOfRun()
   //
   G4cout << "\n List of generated particles (with meanLife != 0) :" << G4endl;
 
-  std::map<G4String, ParticleData>::iterator itc;
-  for (itc = fParticleDataMap1.begin(); itc != fParticleDataMap1.end(); itc++) {
-    G4String name = itc->first;
-    ParticleData data = itc->second;
-    G4int count = data.fCount;
-    G4double eMean = data.fEmean / count;
-    G4double eMin = data.fEmin;
-    G4double eMax = data.fEmax;
-    G4double meanLife = data.fTmean;
-
-    G4cout << "  " << std::setw(13) << name << ": " << std::setw(7) << count
-           << "  Emean = " << std::setw(wid) << G4BestUnit(eMean, "Energy") << "\t( "
-           << G4BestUnit(eMin, "Energy") << " --> " << G4BestUnit(eMax, "Energy") << ")";
-    if (meanLife >= 0.)
-      G4cout << "\tmean life = " << G4BestUnit(meanLife, "Time") << G4endl;
-    else
-      G4cout << "\tstable" << G4endl;
-  }
+  PrintParticleData(fCreatedParticles, false);
 
   // compute mean Energy deposited and rms
   //
@@ -288,28 +385,291 @@ void Run::EndOfRun()
   //
   G4cout << "\n List of particles emerging from the container :" << G4endl;
 
-  std::map<G4String, ParticleData>::iterator itn;
-  for (itn = fParticleDataMap2.begin(); itn != fParticleDataMap2.end(); itn++) {
-    G4String name = itn->first;
-    ParticleData data = itn->second;
+  PrintParticleData(fEmergingParticles, true);
+
+  // total ionising dose in the scoring volumes
+  //
+  WriteDoseSummary();
+
+  // precision reached by the tally of /run/beamOnUntil
+  //
+  if (fTally.fCount > 0) {
+    G4cout << "\n Relative error of the mean " << ConvergenceMonitor::GetTally().fName
+           << " per event = " << fTally.GetRelativeError() << " after " << fTally.fCount
+           << " events (target " << ConvergenceMonitor::GetTarget() << ", "
+           << (ConvergenceMonitor::IsConverged() ? "reached" : "not reached") << ")" << G4endl;
+  }
+
+  // tracks taken by the stacking rules
+  //
+  if (!fStackingCounter.empty()) {
+    G4cout << "\n Tracks killed or deferred by the stacking rules :" << G4endl;
+    for (std::size_t id = 0; id < fStackingCounter.size(); ++id) {
+      if (fStackingCounter[id] == 0) continue;
+      G4cout << "  " << std::setw(9) << fStackingCounter[id] << " tracks, "
+             << std::setw(wid) << G4BestUnit(fStackingEnergy[id], "Energy") << " : "
+             << StackingAction::GetRuleName((G4int)id) << G4endl;
+    }
+  }
+
+  // neutrons killed by the neutron killer
+  //
+  std::uint64_t nbNeutronKills = 0;
+  for (std::uint64_t kills : fNeutronKills) {
+    nbNeutronKills += kills;
+  }
+  if (nbNeutronKills > 0) {
+    G4cout << "\n Neutrons killed by nKiller :" << G4endl;
+    for (G4int reason = 0; reason < NeutronKiller::kNbReasons; ++reason) {
+      if (fNeutronKills[reason] == 0) continue;
+      G4cout << "  " << std::setw(9) << NeutronKiller::GetReasonName(reason) << ": "
+             << std::setw(7) << fNeutronKills[reason]
+             << "  Ekin sum = " << G4BestUnit(fNeutronKillEnergy[reason], "Energy") << G4endl;
+    }
+  }
+
+#ifdef NEUTRONSOURCE_COUNT_ALLOCATIONS
+  // heap allocations in the stepping action for steps not recorded
+  //
+  G4cout << "\n Steps not recorded : " << fUnrecordedSteps << " ; with heap allocations : "
+         << fUnrecordedStepsAllocating << " (" << fUnrecordedStepAllocations
+         << " allocations)" << G4endl;
+#endif
+
+#ifdef NEUTRONSOURCE_PROFILE_STEPPING
+  // time spent in the sections of the stepping and end of event code
+  //
+  fStepProfile.Print();
+#endif
+
+  // remove all contents in fProcCounter, fCount
+  fProcCounter.assign(fProcCounter.size(), 0);
+  fStackingCounter.clear();
+  fStackingEnergy.clear();
+  fNeutronKills.fill(0);
+  fNeutronKillEnergy.fill(0.);
+  fEmergingParticles.clear();
+
+  // restore default format
+  G4cout.precision(dfprec);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::PrintParticleData(const std::vector<ParticleData>& table, G4bool flux)
+{
+  // names are resolved here only, sorted for the printout
+  std::map<G4String, const ParticleData*> byName;
+  for (std::size_t index = 0; index < table.size(); ++index) {
+    if (table[index].fCount == 0) continue;
+    byName[ParticleClassifier::GetParticle((G4int)index)->GetParticleName()] = &table[index];
+  }
+
+  G4int wid = G4cout.precision() + 2;
+  for (const auto& entry : byName) {
+    const G4String& name = entry.first;
+    const ParticleData& data = *entry.second;
     G4int count = data.fCount;
-    G4double eMean = data.fEmean / count;
+    G4double eMean = (data.fSumW > 0.) ? data.fEmean / data.fSumW : 0.;
     G4double eMin = data.fEmin;
     G4double eMax = data.fEmax;
-    G4double Eflow = data.fEmean / TotNbofEvents;
 
     G4cout << "  " << std::setw(13) << name << ": " << std::setw(7) << count
            << "  Emean = " << std::setw(wid) << G4BestUnit(eMean, "Energy") << "\t( "
-           << G4BestUnit(eMin, "Energy") << " --> " << G4BestUnit(eMax, "Energy")
-           << ") \tEflow/event = " << G4BestUnit(Eflow, "Energy") << G4endl;
+           << G4BestUnit(eMin, "Energy") << " --> " << G4BestUnit(eMax, "Energy") << ")";
+    // biased runs: the weighted count is what estimates the yield
+    if (data.fSumW != count) G4cout << "\tweight = " << data.fSumW;
+    if (flux) {
+      G4double Eflow = data.fEmean / numberOfEvent;
+      G4cout << " \tEflow/event = " << G4BestUnit(Eflow, "Energy") << G4endl;
+    }
+    else if (data.fTmean >= 0.)
+      G4cout << "\tmean life = " << G4BestUnit(data.fTmean, "Time") << G4endl;
+    else
+      G4cout << "\tstable" << G4endl;
   }
+}
 
-  // remove all contents in fProcCounter, fCount
-  fProcCounter.clear();
-  fParticleDataMap2.clear();
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-  // restore default format
-  G4cout.precision(dfprec);
+void Run::WriteDoseSummary()
+{
+  static const char* classNames[DoseSummaryRow::kNbClasses] = {
+    "total", "e-&e+", "gamma", "proton", "nucleus", "10B capture"};
+
+  G4bool header = false;
+  for (G4int v = 0; v < kNbScoringVolumes; ++v) {
+    const ScoringVolume volume = static_cast<ScoringVolume>(v);
+    const G4double mass = fDetector->GetScoringMass(volume);
+    if (mass <= 0.) continue;
+
+    DoseSummaryRow row;
+    row.fVolumeName = &ScoringSD::GetDetectorName(volume);
+    row.fMass = mass / kg;
+    row.fNbEvents = numberOfEvent;
+    for (G4int c = 0; c < DoseSummaryRow::kNbClasses; ++c) {
+      row.fEdep[c] = fDoseEdep[v][c] / MeV;
+      row.fDose[c] = fDoseEdep[v][c] / mass / gray;
+    }
+    Ntuples::Instance()->DoseSummary().Fill(row);
+
+    if (!header) {
+      G4cout << "\n Total ionising dose in the scoring volumes :" << G4endl;
+      header = true;
+    }
+    G4cout << "  " << std::setw(14) << *row.fVolumeName << " ("
+           << G4BestUnit(mass, "Mass") << ") :";
+    for (G4int c = 0; c < DoseSummaryRow::kNbClasses; ++c) {
+      G4cout << "  " << classNames[c] << " " << G4BestUnit(fDoseEdep[v][c] / mass, "Dose");
+    }
+    G4cout << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::Save(std::ostream& os) const
+{
+  os << "energy " << fEnergyDeposit << ' ' << fEnergyDeposit2 << ' ' << fEnergyFlow << ' '
+     << fEnergyFlow2 << '\n';
+
+  std::size_t nbProcesses = 0;
+  for (auto count : fProcCounter) {
+    if (count > 0) nbProcesses++;
+  }
+  os << "processes " << nbProcesses << '\n';
+  for (std::size_t code = 0; code < fProcCounter.size(); ++code) {
+    if (fProcCounter[code] == 0) continue;
+    os << ProcessClassifier::GetName((G4int)code) << ' ' << fProcCounter[code] << '\n';
+  }
+
+  os << "stacking " << fStackingCounter.size() << '\n';
+  for (std::size_t rule = 0; rule < fStackingCounter.size(); ++rule) {
+    os << fStackingCounter[rule] << ' ' << fStackingEnergy[rule] << '\n';
+  }
+
+  os << "nKiller";
+  for (G4int reason = 0; reason < NeutronKiller::kNbReasons; ++reason) {
+    os << ' ' << fNeutronKills[reason] << ' ' << fNeutronKillEnergy[reason];
+  }
+  os << '\n';
+
+  os << "created\n";
+  SaveParticleData(os, fCreatedParticles);
+  os << "emerging\n";
+  SaveParticleData(os, fEmergingParticles);
+
+  os << "tally " << fTally.fCount << ' ' << fTally.fMean << ' ' << fTally.fM2 << '\n';
+
+  os << "dose";
+  for (const auto& volume : fDoseEdep) {
+    for (G4double edep : volume) os << ' ' << edep;
+  }
+  os << '\n';
+
+  os << "spectra " << fSpectra.size() << '\n';
+  for (const LogH1& spectrum : fSpectra) spectrum.Save(os);
+  os << "maps " << fFluxMaps.size() << '\n';
+  for (const SparseH2& map : fFluxMaps) map.Save(os);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool Run::Restore(std::istream& is, G4int nbOfEvents)
+{
+  numberOfEvent = nbOfEvents;
+
+  if (!ExpectLabel(is, "energy")) return false;
+  is >> fEnergyDeposit >> fEnergyDeposit2 >> fEnergyFlow >> fEnergyFlow2;
+
+  std::size_t nbProcesses = 0;
+  if (!ExpectLabel(is, "processes") || !(is >> nbProcesses)) return false;
+  for (std::size_t i = 0; i < nbProcesses; ++i) {
+    G4String name;
+    std::uint64_t count = 0;
+    is >> name >> count;
+    const G4int code = ProcessClassifier::GetCode(name);
+    if (code >= (G4int)fProcCounter.size()) fProcCounter.resize(code + 1, 0);
+    fProcCounter[code] = count;
+  }
+
+  std::size_t nbRules = 0;
+  if (!ExpectLabel(is, "stacking") || !(is >> nbRules)) return false;
+  fStackingCounter.assign(nbRules, 0);
+  fStackingEnergy.assign(nbRules, 0.);
+  for (std::size_t rule = 0; rule < nbRules; ++rule) {
+    is >> fStackingCounter[rule] >> fStackingEnergy[rule];
+  }
+
+  if (!ExpectLabel(is, "nKiller")) return false;
+  for (G4int reason = 0; reason < NeutronKiller::kNbReasons; ++reason) {
+    is >> fNeutronKills[reason] >> fNeutronKillEnergy[reason];
+  }
+
+  if (!ExpectLabel(is, "created") || !RestoreParticleData(is, fCreatedParticles)) return false;
+  if (!ExpectLabel(is, "emerging") || !RestoreParticleData(is, fEmergingParticles)) return false;
+
+  if (!ExpectLabel(is, "tally")) return false;
+  is >> fTally.fCount >> fTally.fMean >> fTally.fM2;
+
+  if (!ExpectLabel(is, "dose")) return false;
+  for (auto& volume : fDoseEdep) {
+    for (G4double& edep : volume) is >> edep;
+  }
+
+  std::size_t nbSpectra = 0;
+  if (!ExpectLabel(is, "spectra") || !(is >> nbSpectra)) return false;
+  fSpectra.resize(nbSpectra);
+  for (LogH1& spectrum : fSpectra) {
+    if (!spectrum.Restore(is)) return false;
+  }
+
+  std::size_t nbMaps = 0;
+  if (!ExpectLabel(is, "maps") || !(is >> nbMaps)) return false;
+  fFluxMaps.resize(nbMaps);
+  for (SparseH2& map : fFluxMaps) {
+    if (!map.Restore(is)) return false;
+  }
+  return !is.fail();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::SaveParticleData(std::ostream& os, const std::vector<ParticleData>& table)
+{
+  for (std::size_t index = 0; index < table.size(); ++index) {
+    const ParticleData& data = table[index];
+    if (data.fCount == 0) continue;
+    const G4ParticleDefinition* particle = ParticleClassifier::GetParticle((G4int)index);
+    os << particle->GetParticleName() << ' ' << particle->GetPDGEncoding() << ' ' << data.fCount
+       << ' ' << data.fSumW << ' ' << data.fEmean << ' ' << data.fEmin << ' ' << data.fEmax << ' ' << data.fTmean
+       << '\n';
+  }
+  os << "end\n";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool Run::RestoreParticleData(std::istream& is, std::vector<ParticleData>& table)
+{
+  G4String name;
+  while (is >> name && name != "end") {
+    G4int encoding = 0;
+    ParticleData data;
+    is >> encoding >> data.fCount >> data.fSumW >> data.fEmean >> data.fEmin >> data.fEmax >> data.fTmean;
+
+    // the ions only exist once something created them
+    const G4ParticleDefinition* particle =
+      G4ParticleTable::GetParticleTable()->FindParticle(name);
+    if (particle == nullptr) particle = G4IonTable::GetIonTable()->GetIon(encoding);
+    if (particle == nullptr) {
+      G4cout << "\n --->warning from Run::Restore : particle " << name
+             << " not found, its counts are dropped" << G4endl;
+      continue;
+    }
+    GetParticleData(table, particle).Merge(data);
+  }
+  return !is.fail();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -32,13 +32,19 @@
 
 #include "RunAction.hh"
 
+#include "Checkpoint.hh"
+#include "CheckpointMessenger.hh"
+#include "ConvergenceMessenger.hh"
 #include "DetectorConstruction.hh"
 #include "HistoManager.hh"
+#include "Ntuples.hh"
 #include "PrimaryGeneratorAction.hh"
 #include "Run.hh"
 
 #include "G4Run.hh"
+#include "G4RunManager.hh"
 #include "G4SystemOfUnits.hh"
+#include "G4Threading.hh"
 #include "G4UnitsTable.hh"
 #include "Randomize.hh"
 
@@ -54,145 +60,24 @@ RunAction::RunAction(DetectorConstruction *det, PrimaryGeneratorAction *prim)
   analysisManager->SetVerboseLevel(1);
   // analysisManager->SetNtupleMerging(true); // Merging the ntuples
 
-  // Create ntuple for energy deposition
-  analysisManager->CreateNtuple("NeutronCapture_Data", "NeutronCapture_Data");
-  analysisManager->CreateNtupleIColumn("fEvent");
-  analysisManager->CreateNtupleSColumn("fParticleName");
-  analysisManager->CreateNtupleDColumn("fX");
-  analysisManager->CreateNtupleDColumn("fY");
-  analysisManager->CreateNtupleDColumn("fZ");
-  analysisManager->CreateNtupleSColumn("fInteractionType");
-  analysisManager->CreateNtupleSColumn("targetIsotope");
-  // analysisManager->CreateNtupleDColumn("Edep");
-  analysisManager->FinishNtuple(0);
-
-  // Create ntuple for energy deposition
-  analysisManager->CreateNtuple("BoronEdep", "BoronEdep");
-  analysisManager->CreateNtupleIColumn("fEvent");
-  analysisManager->CreateNtupleSColumn("fParticleName");
-  analysisManager->CreateNtupleIColumn("fParentID");
-  analysisManager->CreateNtupleIColumn("fParticleID");
-  analysisManager->CreateNtupleIColumn("fStepNumber");
-  analysisManager->CreateNtupleDColumn("fX");
-  analysisManager->CreateNtupleDColumn("fY");
-  analysisManager->CreateNtupleDColumn("fZ");
-  analysisManager->CreateNtupleSColumn("fInteractionType");
-  analysisManager->CreateNtupleSColumn("targetIsotope");
-  analysisManager->CreateNtupleDColumn("Edep");
-  analysisManager->CreateNtupleSColumn("fCreatorProcessName");
-
-  analysisManager->FinishNtuple(1);
-
-  // Create ntuple for energy deposition
-  analysisManager->CreateNtuple("SiliconEdep_Y_1", "SiliconEdep_Y_1");
-  analysisManager->CreateNtupleIColumn("fEvent");
-  analysisManager->CreateNtupleSColumn("fParticleName");
-  analysisManager->CreateNtupleIColumn("fParentID");
-  analysisManager->CreateNtupleIColumn("fParticleID");
-  analysisManager->CreateNtupleIColumn("fStepNumber");
-  analysisManager->CreateNtupleDColumn("fX");
-  analysisManager->CreateNtupleDColumn("fY");
-  analysisManager->CreateNtupleDColumn("fZ");
-  analysisManager->CreateNtupleSColumn("fInteractionType");
-  analysisManager->CreateNtupleSColumn("targetIsotope");
-  analysisManager->CreateNtupleDColumn("Edep");
-  analysisManager->CreateNtupleDColumn("StopTable");
-  analysisManager->CreateNtupleDColumn("StopFull");
-  analysisManager->CreateNtupleDColumn("MeandEdx");
-  analysisManager->CreateNtupleDColumn("StopPower");
-  analysisManager->CreateNtupleSColumn("fCreatorProcessName");
-  analysisManager->CreateNtupleSColumn("fPVatVertexname");
-
-  analysisManager->FinishNtuple(2);
-
-  // Create ntuple for energy deposition
-  analysisManager->CreateNtuple("SiliconEdep_Y_2", "SiliconEdep_Y_2");
-  analysisManager->CreateNtupleIColumn("fEvent");
-  analysisManager->CreateNtupleSColumn("fParticleName");
-  analysisManager->CreateNtupleIColumn("fParentID");
-  analysisManager->CreateNtupleIColumn("fParticleID");
-  analysisManager->CreateNtupleIColumn("fStepNumber");
-  analysisManager->CreateNtupleDColumn("fX");
-  analysisManager->CreateNtupleDColumn("fY");
-  analysisManager->CreateNtupleDColumn("fZ");
-  analysisManager->CreateNtupleSColumn("fInteractionType");
-  analysisManager->CreateNtupleSColumn("targetIsotope");
-  analysisManager->CreateNtupleDColumn("Edep");
-  analysisManager->CreateNtupleDColumn("StopTable");
-  analysisManager->CreateNtupleDColumn("StopFull");
-  analysisManager->CreateNtupleDColumn("MeandEdx");
-  analysisManager->CreateNtupleDColumn("StopPower");
-  analysisManager->CreateNtupleSColumn("fCreatorProcessName");
-  analysisManager->CreateNtupleSColumn("fPVatVertexname");
-
-  analysisManager->FinishNtuple(3);
-
-  // Create ntuple for energy deposition
-  analysisManager->CreateNtuple("SiliconEdep_Z_1", "SiliconEdep_Z_1");
-  analysisManager->CreateNtupleIColumn("fEvent");
-  analysisManager->CreateNtupleSColumn("fParticleName");
-  analysisManager->CreateNtupleIColumn("fParentID");
-  analysisManager->CreateNtupleIColumn("fParticleID");
-  analysisManager->CreateNtupleIColumn("fStepNumber");
-  analysisManager->CreateNtupleDColumn("fX");
-  analysisManager->CreateNtupleDColumn("fY");
-  analysisManager->CreateNtupleDColumn("fZ");
-  analysisManager->CreateNtupleSColumn("fInteractionType");
-  analysisManager->CreateNtupleSColumn("targetIsotope");
-  analysisManager->CreateNtupleDColumn("Edep");
-  analysisManager->CreateNtupleDColumn("StopTable");
-  analysisManager->CreateNtupleDColumn("StopFull");
-  analysisManager->CreateNtupleDColumn("MeandEdx");
-  analysisManager->CreateNtupleDColumn("StopPower");
-  analysisManager->CreateNtupleSColumn("fCreatorProcessName");
-  analysisManager->CreateNtupleSColumn("fPVatVertexname");
-
-  analysisManager->FinishNtuple(4);
-
-  // Create ntuple for energy deposition
-  analysisManager->CreateNtuple("SiliconEdep_Z_2", "SiliconEdep_Z_2");
-  analysisManager->CreateNtupleIColumn("fEvent");
-  analysisManager->CreateNtupleSColumn("fParticleName");
-  analysisManager->CreateNtupleIColumn("fParentID");
-  analysisManager->CreateNtupleIColumn("fParticleID");
-  analysisManager->CreateNtupleIColumn("fStepNumber");
-  analysisManager->CreateNtupleDColumn("fX");
-  analysisManager->CreateNtupleDColumn("fY");
-  analysisManager->CreateNtupleDColumn("fZ");
-  analysisManager->CreateNtupleSColumn("fInteractionType");
-  analysisManager->CreateNtupleSColumn("targetIsotope");
-  analysisManager->CreateNtupleDColumn("Edep");
-  analysisManager->CreateNtupleDColumn("StopTable");
-  analysisManager->CreateNtupleDColumn("StopFull");
-  analysisManager->CreateNtupleDColumn("MeandEdx");
-  analysisManager->CreateNtupleDColumn("StopPower");
-  analysisManager->CreateNtupleSColumn("fCreatorProcessName");
-  analysisManager->CreateNtupleSColumn("fPVatVertexname");
-
-  analysisManager->FinishNtuple(5);
-
-  // Create ntuple for particles reaching to the world boundry
-  analysisManager->CreateNtuple("Particles_Exit_World", "Particles_Exit_World");
-  analysisManager->CreateNtupleIColumn("fEvent");
-  analysisManager->CreateNtupleSColumn("fParticleName");
-  analysisManager->CreateNtupleIColumn("fParentID");
-  analysisManager->CreateNtupleIColumn("fParticleID");
-  analysisManager->CreateNtupleIColumn("fStepNumber");
-  analysisManager->CreateNtupleDColumn("fX");
-  analysisManager->CreateNtupleDColumn("fY");
-  analysisManager->CreateNtupleDColumn("fZ");
-  analysisManager->CreateNtupleDColumn("fKinEnergy");
-  analysisManager->CreateNtupleSColumn("fInteractionType");
-  analysisManager->CreateNtupleSColumn("targetIsotope");
-  analysisManager->CreateNtupleSColumn("fCreatorProcessName");
-  analysisManager->CreateNtupleSColumn("fPVatVertexname");
-
-  analysisManager->FinishNtuple(6);
+  // Create the ntuples, the columns are declared in Ntuples.hh
+  Ntuples::Instance()->Book();
+
+  // /run/beamOnUntil and /run/resume start the runs, they are not broadcast.
+  // isMaster is only set after the construction of the worker run actions
+  if (G4Threading::IsMasterThread()) {
+    fConvergenceMessenger = new ConvergenceMessenger(fDetector);
+    fCheckpointMessenger = new CheckpointMessenger();
+  }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-RunAction::~RunAction() { delete fHistoManager; }
+RunAction::~RunAction() {
+  delete fHistoManager;
+  delete fConvergenceMessenger;
+  delete fCheckpointMessenger;
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -216,6 +101,13 @@ void RunAction::BeginOfRunAction(const G4Run *) {
     fRun->SetPrimary(particle, energy);
   }
 
+  // continuation of a run from its checkpoint (sequential mode), it sets
+  // the name of the analysis file
+  if (isMaster && !Checkpoint::BeginOfRun(fRun, fHistoManager)) {
+    G4RunManager::GetRunManager()->AbortRun();
+    return;
+  }
+
   // histograms
   //
   G4AnalysisManager *analysisManager = G4AnalysisManager::Instance();
@@ -227,15 +119,22 @@ void RunAction::BeginOfRunAction(const G4Run *) {
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 void RunAction::EndOfRunAction(const G4Run *) {
-  if (isMaster)
+  if (isMaster) {
     fRun->EndOfRun();
+    fHistoManager->WriteLogSpectra(fRun->GetSpectra());
+    fHistoManager->NormaliseFluxHistograms(fRun->GetNumberOfEvent());
+    fHistoManager->WriteSparseMaps(fRun->GetFluxMaps(),
+                                   fRun->GetNumberOfEvent());
+  }
 
-  // save histograms
+  // save histograms (no file is open if the resume of the run failed)
   G4AnalysisManager *analysisManager = G4AnalysisManager::Instance();
-  if (analysisManager->IsActive()) {
+  if (analysisManager->IsActive() && analysisManager->IsOpenFile()) {
     analysisManager->Write();
     analysisManager->CloseFile();
   }
+  if (isMaster)
+    Checkpoint::EndOfRun();
 
   // show Rndm status
   if (isMaster)
@@ -0,0 +1,69 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ScoringHit.cc
+/// \brief Implementation of the ScoringHit class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "ScoringHit.hh"
+
+#include "StepNames.hh"
+#include "TrackInformation.hh"
+
+#include "G4Step.hh"
+
+G4ThreadLocal G4Allocator<ScoringHit>* ScoringHitAllocator = nullptr;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ScoringHit::ScoringHit(const G4Step* step)
+{
+  const G4Track* track = step->GetTrack();
+  const G4StepPoint* prePoint = step->GetPreStepPoint();
+  const G4StepPoint* postPoint = step->GetPostStepPoint();
+
+  fParticle = track->GetDefinition();
+  fParentID = track->GetParentID();
+  fTrackID = track->GetTrackID();
+  fStepNumber = track->GetCurrentStepNumber();
+  fPosition = postPoint->GetPosition();
+  fProcess = postPoint->GetProcessDefinedStep();
+  // the process forgets its target at the next interaction, keep it now
+  fTargetIsotope = StepNames::TargetIsotope(step);
+  fPostVolume = postPoint->GetPhysicalVolume();
+  fCreatorProcess = track->GetCreatorProcess();
+  fVertexVolume = track->GetLogicalVolumeAtVertex();
+  fAncestry = TrackInformation::GetAncestry(track);
+  fWeight = track->GetWeight();
+  fMaterial = prePoint->GetMaterial();
+  fEdep = step->GetTotalEnergyDeposit();
+  fStepLength = step->GetStepLength();
+  fPreKineticEnergy = prePoint->GetKineticEnergy();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,138 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ScoringSD.cc
+/// \brief Implementation of the ScoringSD class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "ScoringSD.hh"
+#include "StepProfile.hh"
+
+#include "G4HCofThisEvent.hh"
+#include "G4SDManager.hh"
+#include "G4Step.hh"
+
+namespace
+{
+// Indexed by ScoringVolume
+const G4String kDetectorNames[kNbScoringVolumes] = {"BoronConverter", "SiliconY1", "SiliconY2",
+                                                    "SiliconZ1", "SiliconZ2"};
+// Indexed by ScoringSD::Collection
+const G4String kCollectionNames[] = {"ScoringHits", "ScoringSegments"};
+// Set by /stepping/saveSiliconSegments, broadcast to every thread
+G4ThreadLocal G4bool saveSegments = false;
+}  // namespace
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ScoringSD::ScoringSD(ScoringVolume volume)
+  : G4VSensitiveDetector(GetDetectorName(volume)), fVolume(volume)
+{
+  collectionName.insert(kCollectionNames[kStepHits]);
+  if (fVolume != kBoronConverter) collectionName.insert(kCollectionNames[kSegments]);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const G4String& ScoringSD::GetDetectorName(ScoringVolume volume)
+{
+  return kDetectorNames[volume];
+}
+
+G4String ScoringSD::GetCollectionName(ScoringVolume volume, Collection collection)
+{
+  return kDetectorNames[volume] + "/" + kCollectionNames[collection];
+}
+
+void ScoringSD::SetSaveSegments(G4bool save)
+{
+  saveSegments = save;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ScoringSD::Initialize(G4HCofThisEvent* hce)
+{
+  fHitsCollection = new ScoringHitsCollection(SensitiveDetectorName, collectionName[0]);
+  G4int hcID = G4SDManager::GetSDMpointer()->GetCollectionID(fHitsCollection);
+  hce->AddHitsCollection(hcID, fHitsCollection);
+
+  fOpenSegment = nullptr;
+  fSegmentsCollection = nullptr;
+  if (fVolume == kBoronConverter || !saveSegments) return;
+  fSegmentsCollection = new ScoringSegmentsCollection(SensitiveDetectorName, collectionName[1]);
+  hcID = G4SDManager::GetSDMpointer()->GetCollectionID(fSegmentsCollection);
+  hce->AddHitsCollection(hcID, fSegmentsCollection);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ScoringSD::ProcessHits(G4Step* step, G4TouchableHistory*)
+{
+  PROFILE_STEP_SECTION(kScoringSD);
+
+  if (fVolume == kBoronConverter) {
+    fHitsCollection->insert(new ScoringHit(step));
+    return true;
+  }
+
+  if (fSegmentsCollection != nullptr) AddToSegment(step);
+
+  // The silicon step hits only score energy deposits, the dE/dx columns
+  // need a step which stays in the world
+  if (step->GetTotalEnergyDeposit() <= 0. || step->GetStepLength() == 0.
+      || step->GetTrack()->GetNextVolume() == nullptr)
+    return false;
+
+  fHitsCollection->insert(new ScoringHit(step));
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ScoringSD::AddToSegment(const G4Step* step)
+{
+  // Tracks are transported one at a time, so the steps of a passage through
+  // the slab arrive one after the other. A step starting on the boundary
+  // enters the slab and opens a new segment.
+  const G4Track* track = step->GetTrack();
+  if (fOpenSegment == nullptr || fOpenSegment->GetTrackID() != track->GetTrackID()
+      || step->GetPreStepPoint()->GetStepStatus() == fGeomBoundary)
+  {
+    fOpenSegment = new ScoringSegment(step);
+    fSegmentsCollection->insert(fOpenSegment);
+  }
+  fOpenSegment->AddStep(step);
+
+  // Close it when the track leaves the slab or stops
+  if (step->GetPostStepPoint()->GetStepStatus() == fGeomBoundary
+      || track->GetTrackStatus() != fAlive)
+    fOpenSegment = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,75 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ScoringSegment.cc
+/// \brief Implementation of the ScoringSegment class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "ScoringSegment.hh"
+#include "TrackInformation.hh"
+
+#include "G4Step.hh"
+
+#include <algorithm>
+
+G4ThreadLocal G4Allocator<ScoringSegment>* ScoringSegmentAllocator = nullptr;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ScoringSegment::ScoringSegment(const G4Step* step)
+{
+  const G4Track* track = step->GetTrack();
+  const G4StepPoint* prePoint = step->GetPreStepPoint();
+
+  fParticle = track->GetDefinition();
+  fParentID = track->GetParentID();
+  fTrackID = track->GetTrackID();
+  fEntryPosition = prePoint->GetPosition();
+  fExitPosition = prePoint->GetPosition();
+  fEntryKineticEnergy = prePoint->GetKineticEnergy();
+  fCreatorProcess = track->GetCreatorProcess();
+  fVertexVolume = track->GetLogicalVolumeAtVertex();
+  fAncestry = TrackInformation::GetAncestry(track);
+  fWeight = track->GetWeight();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ScoringSegment::AddStep(const G4Step* step)
+{
+  const G4double edep = step->GetTotalEnergyDeposit();
+  const G4double length = step->GetStepLength();
+
+  fExitPosition = step->GetPostStepPoint()->GetPosition();
+  fEdep += edep;
+  fTrackLength += length;
+  if (length > 0.) fMaxDEDX = std::max(fMaxDEDX, edep / length);
+  fNbOfSteps++;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
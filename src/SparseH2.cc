@@ -0,0 +1,114 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file SparseH2.cc
+/// \brief Implementation of the SparseH2 class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "SparseH2.hh"
+
+#include <cmath>
+#include <istream>
+#include <ostream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SparseH2::SparseH2(G4int nbinsX, G4double xmin, G4double xmax, G4int nbinsY, G4double ymin,
+                   G4double ymax)
+  : fNbinsX(nbinsX),
+    fNbinsY(nbinsY),
+    fXmin(xmin),
+    fYmin(ymin),
+    fInvWidthX(nbinsX / (xmax - xmin)),
+    fInvWidthY(nbinsY / (ymax - ymin))
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SparseH2::Fill(G4double x, G4double y, G4double weight)
+{
+  const G4double u = std::floor((x - fXmin) * fInvWidthX);
+  const G4double v = std::floor((y - fYmin) * fInvWidthY);
+  if (u < 0. || u >= fNbinsX || v < 0. || v >= fNbinsY) {
+    fOutOfRange += weight;
+    return;
+  }
+
+  Bin& bin = fBins[std::uint32_t(u) + std::uint32_t(fNbinsX) * std::uint32_t(v)];
+  bin.fSumW += weight;
+  bin.fSumW2 += weight * weight;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SparseH2::Merge(const SparseH2& other)
+{
+  for (const auto& [key, otherBin] : other.fBins) {
+    Bin& bin = fBins[key];
+    bin.fSumW += otherBin.fSumW;
+    bin.fSumW2 += otherBin.fSumW2;
+  }
+  fOutOfRange += other.fOutOfRange;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SparseH2::Reset()
+{
+  fBins.clear();
+  fOutOfRange = 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SparseH2::Save(std::ostream& os) const
+{
+  os << fNbinsX << ' ' << fXmin << ' ' << fInvWidthX << ' ' << fNbinsY << ' ' << fYmin << ' '
+     << fInvWidthY << ' ' << fOutOfRange << ' ' << fBins.size() << '\n';
+  for (const auto& [key, bin] : fBins) {
+    os << key << ' ' << bin.fSumW << ' ' << bin.fSumW2 << '\n';
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SparseH2::Restore(std::istream& is)
+{
+  std::size_t nbBins = 0;
+  is >> fNbinsX >> fXmin >> fInvWidthX >> fNbinsY >> fYmin >> fInvWidthY >> fOutOfRange >> nbBins;
+  fBins.clear();
+  for (std::size_t i = 0; i < nbBins && is; ++i) {
+    std::uint32_t key = 0;
+    is >> key;
+    Bin& bin = fBins[key];
+    is >> bin.fSumW >> bin.fSumW2;
+  }
+  return !is.fail();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,161 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file StackingAction.cc
+/// \brief Implementation of the StackingAction class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "StackingAction.hh"
+
+#include "Run.hh"
+#include "StackingActionMessenger.hh"
+
+#include "G4AutoLock.hh"
+#include "G4RunManager.hh"
+#include "G4Track.hh"
+
+#include <map>
+
+namespace
+{
+G4Mutex registryMutex = G4MUTEX_INITIALIZER;
+std::map<G4String, G4int> registryIds;
+std::vector<G4String> registryNames;
+
+const char* ClassificationName(G4ClassificationOfNewTrack classification)
+{
+  return (classification == fKill) ? "kill" : "defer";
+}
+}  // namespace
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StackingAction::StackingAction()
+{
+  fStackingMessenger = new StackingActionMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StackingAction::~StackingAction()
+{
+  delete fStackingMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StackingAction::PrepareNewEvent()
+{
+  if (fRules.empty()) return;
+
+  // The geometry may change between runs, the filters look up the volumes
+  // once per run
+  const G4Run* run = G4RunManager::GetRunManager()->GetCurrentRun();
+  if (run == nullptr || run->GetRunID() == fFilterRunID) return;
+  for (Rule& rule : fRules) {
+    rule.fFilter.Prepare();
+  }
+  fFilterRunID = run->GetRunID();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4ClassificationOfNewTrack StackingAction::ClassifyNewTrack(const G4Track* track)
+{
+  if (fRules.empty() || track->GetParentID() == 0) return fUrgent;
+
+  for (Rule& rule : fRules) {
+    if (!rule.fFilter.Accept(track)) continue;
+    Run* run = static_cast<Run*>(G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+    run->CountStackingRule(rule.fId, track->GetKineticEnergy());
+    return rule.fClassification;
+  }
+  return fUrgent;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StackingAction::AddRule(G4ClassificationOfNewTrack classification,
+                             const G4String& expression)
+{
+  Rule rule;
+  G4String error;
+  if (!rule.fFilter.Compile(expression, error)) {
+    G4cout << "\n --->warning from StackingAction::AddRule : " << error << " in \""
+           << expression << "\". Command refused" << G4endl;
+    return;
+  }
+  rule.fClassification = classification;
+  rule.fId = Register(G4String(ClassificationName(classification)) + " " + expression);
+  fRules.push_back(std::move(rule));
+  // resolve the volume names at the next event
+  fFilterRunID = -1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StackingAction::ClearRules()
+{
+  fRules.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StackingAction::ListRules() const
+{
+  G4cout << "\n Stacking rules (first match applies):";
+  if (fRules.empty()) G4cout << " none, every track is tracked";
+  for (const Rule& rule : fRules) {
+    G4cout << "\n   " << ClassificationName(rule.fClassification) << " : "
+           << rule.fFilter.GetExpression();
+  }
+  G4cout << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int StackingAction::Register(const G4String& name)
+{
+  G4AutoLock lock(&registryMutex);
+  auto it = registryIds.find(name);
+  if (it != registryIds.end()) return it->second;
+  G4int id = (G4int)registryNames.size();
+  registryIds[name] = id;
+  registryNames.push_back(name);
+  return id;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String StackingAction::GetRuleName(G4int id)
+{
+  G4AutoLock lock(&registryMutex);
+  return (id >= 0 && id < (G4int)registryNames.size()) ? registryNames[id] : "";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
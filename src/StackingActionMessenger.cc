@@ -0,0 +1,109 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file StackingActionMessenger.cc
+/// \brief Implementation of the StackingActionMessenger class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "StackingActionMessenger.hh"
+
+#include "StackingAction.hh"
+
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4UIdirectory.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StackingActionMessenger::StackingActionMessenger(StackingAction* stack) : fStackingAction(stack)
+{
+  fStackingDir = new G4UIdirectory("/stacking/");
+  fStackingDir->SetGuidance("Kill or defer new tracks before they are tracked.");
+  fStackingDir->SetGuidance("Rules are expressions over particle, volume, region, process "
+                            "and energy of the new track, e.g.");
+  fStackingDir->SetGuidance("  particle == e- && energy < 1 keV && volume == World");
+
+  fKillCmd = new G4UIcmdWithAString("/stacking/kill", this);
+  fKillCmd->SetGuidance("Kill the new secondaries matching the expression.");
+  fKillCmd->SetGuidance("Rules are tried in the order they were given.");
+  fKillCmd->SetParameterName("expression", false);
+  fKillCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fKillCmd->SetToBeBroadcasted(true);
+
+  fDeferCmd = new G4UIcmdWithAString("/stacking/defer", this);
+  fDeferCmd->SetGuidance("Track the new secondaries matching the expression "
+                         "after all the others (waiting stack).");
+  fDeferCmd->SetGuidance("Rules are tried in the order they were given.");
+  fDeferCmd->SetParameterName("expression", false);
+  fDeferCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fDeferCmd->SetToBeBroadcasted(true);
+
+  fClearCmd = new G4UIcmdWithoutParameter("/stacking/clear", this);
+  fClearCmd->SetGuidance("Remove all rules, every track is tracked.");
+  fClearCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fClearCmd->SetToBeBroadcasted(true);
+
+  fListCmd = new G4UIcmdWithoutParameter("/stacking/list", this);
+  fListCmd->SetGuidance("Print the stacking rules.");
+  fListCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fListCmd->SetToBeBroadcasted(true);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StackingActionMessenger::~StackingActionMessenger()
+{
+  delete fKillCmd;
+  delete fDeferCmd;
+  delete fClearCmd;
+  delete fListCmd;
+  delete fStackingDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StackingActionMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if (command == fKillCmd) {
+    fStackingAction->AddRule(fKill, newValue);
+  }
+
+  if (command == fDeferCmd) {
+    fStackingAction->AddRule(fWaiting, newValue);
+  }
+
+  if (command == fClearCmd) {
+    fStackingAction->ClearRules();
+  }
+
+  if (command == fListCmd) {
+    fStackingAction->ListRules();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
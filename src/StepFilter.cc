@@ -0,0 +1,466 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file StepFilter.cc
+/// \brief Implementation of the StepFilter class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "StepFilter.hh"
+
+#include "ProcessClassifier.hh"
+
+#include "G4IonTable.hh"
+#include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4NistManager.hh"
+#include "G4ParticleTable.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4Step.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4UnitsTable.hh"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+// Characters which end a name or a number
+const char* const kOperatorChars = "=!<>&|()";
+
+// Splits the expression into names, numbers, operators and parentheses
+std::vector<G4String> Tokenize(const G4String& expression)
+{
+  std::vector<G4String> tokens;
+  std::size_t i = 0;
+  while (i < expression.size()) {
+    const char c = expression[i];
+    if (std::isspace(static_cast<unsigned char>(c))) {
+      ++i;
+      continue;
+    }
+    if (std::strchr(kOperatorChars, c) != nullptr) {
+      // two-character operators: == != <= >= && ||
+      std::size_t n = 1;
+      if (i + 1 < expression.size()) {
+        const char d = expression[i + 1];
+        if ((d == '=' && std::strchr("=!<>", c) != nullptr) || (c == '&' && d == '&')
+            || (c == '|' && d == '|'))
+          n = 2;
+      }
+      tokens.push_back(expression.substr(i, n));
+      i += n;
+      continue;
+    }
+    std::size_t j = i;
+    while (j < expression.size() && !std::isspace(static_cast<unsigned char>(expression[j]))
+           && std::strchr(kOperatorChars, expression[j]) == nullptr)
+      ++j;
+    tokens.push_back(expression.substr(i, j - i));
+    i = j;
+  }
+  return tokens;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Recursive descent parser, && binds tighter than ||
+class Parser
+{
+  public:
+    using Node = StepFilter::Node;
+
+    Parser(const std::vector<G4String>& tokens, G4String& error)
+      : fTokens(tokens), fError(error)
+    {}
+
+    std::unique_ptr<Node> Parse()
+    {
+      std::unique_ptr<Node> node = ParseOr();
+      if (node != nullptr && fPos < fTokens.size()) return Fail("unexpected '" + Peek() + "'");
+      return node;
+    }
+
+  private:
+    const G4String& Peek() const
+    {
+      static const G4String end = "end of expression";
+      return (fPos < fTokens.size()) ? fTokens[fPos] : end;
+    }
+
+    G4bool Accept(const char* token)
+    {
+      if (fPos >= fTokens.size() || fTokens[fPos] != token) return false;
+      ++fPos;
+      return true;
+    }
+
+    std::unique_ptr<Node> Fail(const G4String& message)
+    {
+      fError = message;
+      return nullptr;
+    }
+
+    std::unique_ptr<Node> Combine(StepFilter::NodeType type, std::unique_ptr<Node> left,
+                                  std::unique_ptr<Node> right)
+    {
+      auto node = std::make_unique<Node>();
+      node->fType = type;
+      node->fLeft = std::move(left);
+      node->fRight = std::move(right);
+      return node;
+    }
+
+    std::unique_ptr<Node> ParseOr()
+    {
+      std::unique_ptr<Node> left = ParseAnd();
+      while (left != nullptr && Accept("||")) {
+        std::unique_ptr<Node> right = ParseAnd();
+        if (right == nullptr) return nullptr;
+        left = Combine(StepFilter::kOr, std::move(left), std::move(right));
+      }
+      return left;
+    }
+
+    std::unique_ptr<Node> ParseAnd()
+    {
+      std::unique_ptr<Node> left = ParseUnary();
+      while (left != nullptr && Accept("&&")) {
+        std::unique_ptr<Node> right = ParseUnary();
+        if (right == nullptr) return nullptr;
+        left = Combine(StepFilter::kAnd, std::move(left), std::move(right));
+      }
+      return left;
+    }
+
+    std::unique_ptr<Node> ParseUnary()
+    {
+      if (Accept("!")) {
+        std::unique_ptr<Node> operand = ParseUnary();
+        if (operand == nullptr) return nullptr;
+        return Combine(StepFilter::kNot, std::move(operand), nullptr);
+      }
+      if (Accept("(")) {
+        std::unique_ptr<Node> node = ParseOr();
+        if (node == nullptr) return nullptr;
+        if (!Accept(")")) return Fail("missing ')' before '" + Peek() + "'");
+        return node;
+      }
+      if (Accept("all")) return std::make_unique<Node>();
+      return ParseComparison();
+    }
+
+    std::unique_ptr<Node> ParseComparison()
+    {
+      auto node = std::make_unique<Node>();
+      const G4String field = Peek();
+      if (field == "particle")
+        node->fType = StepFilter::kParticle;
+      else if (field == "volume")
+        node->fType = StepFilter::kVolume;
+      else if (field == "region")
+        node->fType = StepFilter::kRegion;
+      else if (field == "process")
+        node->fType = StepFilter::kProcess;
+      else if (field == "energy")
+        node->fType = StepFilter::kEnergy;
+      else if (field == "edep")
+        node->fType = StepFilter::kEdep;
+      else
+        return Fail("unknown field '" + field + "'");
+      ++fPos;
+
+      const G4String op = Peek();
+      if (op == "==")
+        node->fComparison = StepFilter::kEqual;
+      else if (op == "!=")
+        node->fComparison = StepFilter::kNotEqual;
+      else if (op == "<")
+        node->fComparison = StepFilter::kLess;
+      else if (op == "<=")
+        node->fComparison = StepFilter::kLessEqual;
+      else if (op == ">")
+        node->fComparison = StepFilter::kGreater;
+      else if (op == ">=")
+        node->fComparison = StepFilter::kGreaterEqual;
+      else
+        return Fail("expected a comparison after '" + field + "', got '" + op + "'");
+      ++fPos;
+
+      if (fPos >= fTokens.size()) return Fail("missing value after '" + field + " " + op + "'");
+      const G4String value = fTokens[fPos++];
+
+      if (node->fType == StepFilter::kEnergy || node->fType == StepFilter::kEdep) {
+        char* end = nullptr;
+        node->fValue = std::strtod(value.c_str(), &end);
+        if (end == value.c_str() || *end != '\0') return Fail("'" + value + "' is not a number");
+        // optional energy unit, MeV by default
+        G4double unit = MeV;
+        if (fPos < fTokens.size() && G4UnitDefinition::IsUnitDefined(fTokens[fPos])) {
+          if (G4UnitDefinition::GetCategory(fTokens[fPos]) != "Energy")
+            return Fail("'" + fTokens[fPos] + "' is not an energy unit");
+          unit = G4UnitDefinition::GetValueOf(fTokens[fPos++]);
+        }
+        node->fValue *= unit;
+        return node;
+      }
+
+      if (node->fComparison != StepFilter::kEqual && node->fComparison != StepFilter::kNotEqual)
+        return Fail("'" + field + "' can only be compared with == or !=");
+      node->fName = value;
+      // before the physics is built no process is known, Prepare() looks the
+      // name up at the start of the run
+      if (node->fType == StepFilter::kProcess) {
+        node->fProcessCode = ProcessClassifier::FindCode(value);
+        if (node->fProcessCode < 0 && ProcessClassifier::GetNbCodes() > 0)
+          return Fail("unknown process '" + value + "'");
+      }
+      return node;
+    }
+
+    const std::vector<G4String>& fTokens;
+    G4String& fError;
+    std::size_t fPos = 0;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Ground state ion of a name such as Li7 or C12, created if needed: ions
+// are only in the particle table once something asked for them
+const G4ParticleDefinition* FindIon(const G4String& name)
+{
+  std::size_t n = 0;
+  while (n < name.size() && std::isalpha(static_cast<unsigned char>(name[n])))
+    ++n;
+  if (n == 0 || n == name.size()) return nullptr;
+  char* end = nullptr;
+  const long A = std::strtol(name.c_str() + n, &end, 10);
+  if (*end != '\0' || A <= 0) return nullptr;
+  const G4int Z = G4NistManager::Instance()->GetZ(name.substr(0, n));
+  if (Z <= 0 || Z > A) return nullptr;
+  const G4ParticleDefinition* ion = G4IonTable::GetIonTable()->GetIon(Z, (G4int)A);
+  return (ion != nullptr && ion->GetParticleName() == name) ? ion : nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool Compare(G4double value, StepFilter::Comparison comparison, G4double reference)
+{
+  switch (comparison) {
+    case StepFilter::kEqual:
+      return value == reference;
+    case StepFilter::kNotEqual:
+      return value != reference;
+    case StepFilter::kLess:
+      return value < reference;
+    case StepFilter::kLessEqual:
+      return value <= reference;
+    case StepFilter::kGreater:
+      return value > reference;
+    case StepFilter::kGreaterEqual:
+      return value >= reference;
+  }
+  return false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// What the fields read on a step
+struct StepSource
+{
+    const G4Step* fStep;
+    G4int fProcessCode;
+
+    const G4ParticleDefinition* Particle() const { return fStep->GetTrack()->GetDefinition(); }
+    const G4LogicalVolume* Volume() const
+    {
+      return fStep->GetPreStepPoint()->GetPhysicalVolume()->GetLogicalVolume();
+    }
+    G4int ProcessCode() const { return fProcessCode; }
+    G4double Energy() const { return fStep->GetPreStepPoint()->GetKineticEnergy(); }
+    G4double Edep() const { return fStep->GetTotalEnergyDeposit(); }
+};
+
+// ... and on a new track, which has not made a step yet
+struct TrackSource
+{
+    const G4Track* fTrack;
+
+    const G4ParticleDefinition* Particle() const { return fTrack->GetDefinition(); }
+    const G4LogicalVolume* Volume() const
+    {
+      // secondaries get the touchable of their parent, primaries have none
+      const G4VPhysicalVolume* volume = fTrack->GetVolume();
+      return (volume != nullptr) ? volume->GetLogicalVolume() : nullptr;
+    }
+    G4int ProcessCode() const
+    {
+      return ProcessClassifier::Instance()->Classify(fTrack->GetCreatorProcess()).fCode;
+    }
+    G4double Energy() const { return fTrack->GetKineticEnergy(); }
+    G4double Edep() const { return 0.; }
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+template<class Source>
+G4bool EvaluateNode(StepFilter::Node& node, const Source& source)
+{
+  const G4bool equal = (node.fComparison == StepFilter::kEqual);
+  switch (node.fType) {
+    case StepFilter::kAnd:
+      return EvaluateNode(*node.fLeft, source) && EvaluateNode(*node.fRight, source);
+    case StepFilter::kOr:
+      return EvaluateNode(*node.fLeft, source) || EvaluateNode(*node.fRight, source);
+    case StepFilter::kNot:
+      return !EvaluateNode(*node.fLeft, source);
+    case StepFilter::kTrue:
+      return true;
+    case StepFilter::kParticle:
+      // unknown names are false whatever the comparison
+      return node.fParticle != nullptr && (source.Particle() == node.fParticle) == equal;
+    case StepFilter::kVolume: {
+      const G4LogicalVolume* volume = source.Volume();
+      const G4bool found =
+        std::find(node.fVolumes.begin(), node.fVolumes.end(), volume) != node.fVolumes.end();
+      return found == equal;
+    }
+    case StepFilter::kRegion: {
+      const G4LogicalVolume* volume = source.Volume();
+      const G4bool found =
+        volume != nullptr && node.fRegion != nullptr && volume->GetRegion() == node.fRegion;
+      return found == equal;
+    }
+    case StepFilter::kProcess:
+      return node.fProcessCode >= 0 && (source.ProcessCode() == node.fProcessCode) == equal;
+    case StepFilter::kEnergy:
+      return Compare(source.Energy(), node.fComparison, node.fValue);
+    case StepFilter::kEdep:
+      return Compare(source.Edep(), node.fComparison, node.fValue);
+  }
+  return false;
+}
+}  // namespace
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StepFilter::StepFilter(const G4String& expression)
+{
+  G4String error;
+  if (!Compile(expression, error)) {
+    G4cout << "\n --->warning from StepFilter: " << error << " in \"" << expression
+           << "\". Every step is accepted" << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool StepFilter::Compile(const G4String& expression, G4String& error)
+{
+  const std::vector<G4String> tokens = Tokenize(expression);
+  if (tokens.empty()) {
+    error = "empty expression";
+    return false;
+  }
+
+  Parser parser(tokens, error);
+  std::unique_ptr<Node> root = parser.Parse();
+  if (root == nullptr) return false;
+
+  // "all" needs no tree
+  if (root->fType == kTrue) root.reset();
+  fRoot = std::move(root);
+  fExpression = expression;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepFilter::Prepare()
+{
+  if (fRoot != nullptr) Prepare(*fRoot);
+}
+
+void StepFilter::Prepare(Node& node)
+{
+  if (node.fLeft != nullptr) Prepare(*node.fLeft);
+  if (node.fRight != nullptr) Prepare(*node.fRight);
+
+  if (node.fType == kParticle) {
+    node.fParticle = G4ParticleTable::GetParticleTable()->FindParticle(node.fName);
+    if (node.fParticle == nullptr) node.fParticle = FindIon(node.fName);
+    if (node.fParticle == nullptr) {
+      G4cout << "\n --->warning from StepFilter: no particle named " << node.fName << " in \""
+             << fExpression << "\", the comparison is always false" << G4endl;
+    }
+  }
+
+  if (node.fType == kProcess && node.fProcessCode < 0) {
+    node.fProcessCode = ProcessClassifier::FindCode(node.fName);
+    if (node.fProcessCode < 0) {
+      G4cout << "\n --->warning from StepFilter: no process named " << node.fName << " in \""
+             << fExpression << "\", the comparison is always false" << G4endl;
+    }
+  }
+
+  if (node.fType == kVolume) {
+    // several slabs can share a name (the material name)
+    node.fVolumes.clear();
+    for (const G4LogicalVolume* volume : *G4LogicalVolumeStore::GetInstance()) {
+      if (volume->GetName() == node.fName) node.fVolumes.push_back(volume);
+    }
+    if (node.fVolumes.empty()) {
+      G4cout << "\n --->warning from StepFilter: no volume named " << node.fName << " in \""
+             << fExpression << "\"" << G4endl;
+    }
+  }
+
+  if (node.fType == kRegion) {
+    node.fRegion = G4RegionStore::GetInstance()->GetRegion(node.fName, false);
+    if (node.fRegion == nullptr) {
+      G4cout << "\n --->warning from StepFilter: no region named " << node.fName << " in \""
+             << fExpression << "\"" << G4endl;
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool StepFilter::Evaluate(Node& node, const G4Step* step, G4int processCode)
+{
+  return EvaluateNode(node, StepSource{step, processCode});
+}
+
+G4bool StepFilter::Evaluate(Node& node, const G4Track* track)
+{
+  return EvaluateNode(node, TrackSource{track});
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
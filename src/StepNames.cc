@@ -0,0 +1,96 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file StepNames.cc
+/// \brief Implementation of the StepNames helpers
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "StepNames.hh"
+
+#include "ProcessClassifier.hh"
+
+#include "G4HadronicProcess.hh"
+#include "G4Isotope.hh"
+#include "G4Step.hh"
+#include "G4VPhysicalVolume.hh"
+
+namespace
+{
+const G4String kOutOfWorld = "Out_of_World";
+const G4String kNoCreator = "NoCreator";
+const G4String kNoPostProcess = "No PostProcess";
+}  // namespace
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const G4String& StepNames::Volume(const G4VPhysicalVolume* pv)
+{
+  return (pv != nullptr) ? pv->GetName() : kOutOfWorld;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const G4String& StepNames::Creator(G4int parentID, const G4VProcess* creator)
+{
+  return (parentID != 0 && creator != nullptr) ? creator->GetProcessName() : kNoCreator;
+}
+
+const G4String& StepNames::Creator(const G4Track* track)
+{
+  return Creator(track->GetParentID(), track->GetCreatorProcess());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const G4String& StepNames::Process(const G4VProcess* process)
+{
+  return (process != nullptr) ? process->GetProcessName() : kNoPostProcess;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const G4Isotope* StepNames::TargetIsotope(const G4Step* step)
+{
+  const G4VProcess* process = step->GetPostStepPoint()->GetProcessDefinedStep();
+  G4HadronicProcess* hproc = ProcessClassifier::Instance()->Classify(process).fHadronic;
+  return (hproc != nullptr) ? hproc->GetTargetIsotope() : nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const G4String& StepNames::Target(const G4Isotope* target, const G4VPhysicalVolume* postPV)
+{
+  return (target != nullptr) ? target->GetName() : Volume(postPV);
+}
+
+const G4String& StepNames::Target(const G4Step* step)
+{
+  return Target(TargetIsotope(step), step->GetPostStepPoint()->GetPhysicalVolume());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,105 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file StepProfile.cc
+/// \brief Implementation of the StepProfile class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "StepProfile.hh"
+
+#include "Run.hh"
+
+#include "G4RunManager.hh"
+
+#include <iomanip>
+
+namespace
+{
+const char* const kSectionNames[StepProfile::kNbSections] = {
+  "step (total)",    "count processes", "tag secondaries", "track summary",
+  "filters",         "neutron capture row", "exit world row", "print step",
+  "scoring SD",      "event triggers",  "staged rows",     "scoring hits",
+  "  dE/dx",         "silicon segments"};
+}  // namespace
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifdef NEUTRONSOURCE_PROFILE_STEPPING
+StepProfile& StepProfile::Current()
+{
+  return static_cast<Run*>(G4RunManager::GetRunManager()->GetNonConstCurrentRun())
+    ->GetStepProfile();
+}
+#endif
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepProfile::Merge(const StepProfile& other)
+{
+  for (G4int i = 0; i < kNbSections; ++i) {
+    fCalls[i] += other.fCalls[i];
+    fTicks[i] += other.fTicks[i];
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepProfile::Print() const
+{
+  const std::uint64_t steps = fCalls[kStep];
+  const std::uint64_t stepTicks = fTicks[kStep];
+
+  G4cout << "\n Stepping cost (time stamp counter ticks, summed over threads) :"
+         << "\n " << std::setw(20) << std::left << "section" << std::right << std::setw(14)
+         << "calls" << std::setw(12) << "per step" << std::setw(14) << "ticks/call"
+         << std::setw(16) << "Mticks" << std::setw(12) << "% of step" << G4endl;
+
+  const std::ios::fmtflags flags = G4cout.flags();
+  const std::streamsize precision = G4cout.precision();
+  G4cout << std::fixed;
+  for (G4int i = 0; i < kNbSections; ++i) {
+    if (fCalls[i] == 0) continue;
+    const G4double perStep = (steps > 0) ? G4double(fCalls[i]) / steps : 0.;
+    const G4double perCall = G4double(fTicks[i]) / fCalls[i];
+    // relative to the stepping action, the end of event is not per step
+    const G4bool inStep = (i <= kScoringSD);
+    G4cout << " " << std::setw(20) << std::left << kSectionNames[i] << std::right
+           << std::setw(14) << fCalls[i] << std::setw(12) << std::setprecision(4) << perStep
+           << std::setw(14) << std::setprecision(1) << perCall << std::setw(16)
+           << std::setprecision(3) << fTicks[i] * 1.e-6 << std::setw(12);
+    if (inStep && stepTicks > 0)
+      G4cout << std::setprecision(1) << 100. * fTicks[i] / stepTicks;
+    else
+      G4cout << "-";
+    G4cout << G4endl;
+  }
+  G4cout.flags(flags);
+  G4cout.precision(precision);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
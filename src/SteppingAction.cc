@@ -31,26 +31,48 @@
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 #include "SteppingAction.hh"
-#include "G4EmCalculator.hh"
 #include "SteppingActionMessenger.hh"
 
+#include "AllocationCounter.hh"
+#include "DetectorConstruction.hh"
 #include "EventAction.hh"
 #include "HistoManager.hh"
+#include "Ntuples.hh"
+#include "ProcessClassifier.hh"
 #include "Run.hh"
+#include "ScoringSD.hh"
+#include "StepNames.hh"
+#include "StepProfile.hh"
+#include "TrackInformation.hh"
 
+#include "G4DecayProcessType.hh"
 #include "G4HadronicProcess.hh"
+#include "G4HadronicProcessType.hh"
+#include "G4Isotope.hh"
+
 #include "G4RunManager.hh"
 
 #include "G4SystemOfUnits.hh"
-#include <any>
 #include <iostream>
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-SteppingAction::SteppingAction(EventAction *event) : fEventAction(event) {
+static G4int CurrentEventID() {
+  return G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID();
+}
+
+// Steps written to NeutronCapture_Data unless changed with
+// /stepping/filter/neutronCapture
+static const char *const kDefaultNeutronCaptureFilter =
+    "particle == neutron && process == neutronInelastic";
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SteppingAction::SteppingAction(DetectorConstruction *det, EventAction *event)
+    : fDetector(det), fEventAction(event),
+      fNeutronCaptureFilter(kDefaultNeutronCaptureFilter) {
 
   steppingMessenger = new SteppingActionMessenger(this);
-  save_silicon_data = 0;
   save_flux_data = 0;
 }
 
@@ -61,612 +83,214 @@ SteppingAction::~SteppingAction() { delete steppingMessenger; }
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 void SteppingAction::UserSteppingAction(const G4Step *aStep) {
+#ifdef NEUTRONSOURCE_COUNT_ALLOCATIONS
+  // Debug builds check that steps which are not recorded do not allocate
+  const std::uint64_t allocations = AllocationCounter::Count();
+  const G4bool recorded = RecordStep(aStep);
+  Run *run = static_cast<Run *>(
+      G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+  run->CountStepAllocations(recorded, AllocationCounter::Count() - allocations);
+#else
+  RecordStep(aStep);
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SteppingAction::RecordStep(const G4Step *aStep) {
+  PROFILE_STEP_SECTION(kStep);
+
   // count processes
   //
   const G4StepPoint *endPoint = aStep->GetPostStepPoint();
   const G4VProcess *process = endPoint->GetProcessDefinedStep();
   Run *run = static_cast<Run *>(
       G4RunManager::GetRunManager()->GetNonConstCurrentRun());
-  run->CountProcesses(process);
+  const ProcessInfo *processInfo = nullptr;
+  {
+    PROFILE_STEP_SECTION(kCountProcesses);
+    processInfo = &ProcessClassifier::Instance()->Classify(process);
+    run->CountProcesses(processInfo->fCode);
+  }
+
+  // Ancestry of the secondaries created in this step
+  const std::vector<const G4Track *> *secondaries =
+      aStep->GetSecondaryInCurrentStep();
+  if (secondaries != nullptr && !secondaries->empty()) {
+    PROFILE_STEP_SECTION(kTagSecondaries);
+    TagSecondaries(aStep, *processInfo, *secondaries);
+  }
 
   // ############################################################################################//
   // #  Accesing Track and Step information #//
   // ############################################################################################//
+  // Only pointers and numbers are collected here. Names are resolved when a
+  // row is written, see StepNames.
 
   // Track object
   G4Track *theTrack = aStep->GetTrack();
+  const G4ParticleDefinition *particleType = theTrack->GetDefinition();
   // Objects for pre- and post-positions of the track
   G4StepPoint *thePrePoint = aStep->GetPreStepPoint();
   G4StepPoint *thePostPoint = aStep->GetPostStepPoint();
-
-  // ############################################################################################//
-  // #  PARTICLE INFORMATION #//
-  // ############################################################################################//
-  // Particle Name
-  G4ParticleDefinition *particleType = theTrack->GetDefinition();
-  // G4String fParticleName = particleType->GetParticleName();
-  G4String fParticleName = aStep->GetTrack()
-                               ->GetDynamicParticle()
-                               ->GetDefinition()
-                               ->GetParticleName();
-
-  G4ThreeVector posParticle = thePostPoint->GetPosition();
-
-  G4int StepNumberr = aStep->GetTrack()->GetCurrentStepNumber();
-  G4int part_parent_ID = theTrack->GetParentID();
-  G4int part_ID = theTrack->GetTrackID();
-  // ############################################################################################//
-  // #  PARTICLE VOLUMES #//
-  // ############################################################################################//
-  // Vertex volume of the corresponding particle
-  const G4LogicalVolume *PVatVertex = theTrack->GetLogicalVolumeAtVertex();
-  G4String PVatVertexname = PVatVertex->GetName();
   // Particle pre and post step volume
-  G4VPhysicalVolume *thePostPV = thePostPoint->GetPhysicalVolume();
   G4VPhysicalVolume *thePrePV = thePrePoint->GetPhysicalVolume();
+  G4VPhysicalVolume *thePostPV = thePostPoint->GetPhysicalVolume();
 
-  // thePrePV =  nullptr;
-  // G4VPhysicalVolume *thePrePV =  nullptr;
-  // thePrePV = thePrePoint->GetPhysicalVolume();
-  G4String thePrePVname = "";
-  if (thePrePV == nullptr) {
-    thePrePVname = "Out_of_World";
-  } else {
-    // Get the name of the previous physical volume
-    thePrePVname = thePrePV->GetName();
-  }
-
-  // Current physical volume of the particle
-  // G4VPhysicalVolume *thePostPV =  nullptr;
-  // thePostPV =  nullptr;
-  // thePostPV = thePostPoint->GetPhysicalVolume();
-  G4String thePostPVname = "";
-  if (thePostPV == nullptr) {
-    thePostPVname = "Out_of_World";
-  } else {
-    // Get the name of the current physical volume
-    thePostPVname = thePostPV->GetName();
-  }
-
-  // ############################################################################################//
-  // #  Particle Interactions #//
-  // ############################################################################################//
-
-  // Get the creator process for the current particle
-  const G4VProcess *creatorProcess = theTrack->GetCreatorProcess();
-  G4String creatorProcessName = "";
-
-  // part_parent_ID > 0
-
-  if (part_parent_ID != 0) {
-    // G4cout << "creatorProcess->GetProcessName(): " <<
-    // creatorProcess->GetProcessName() << std::endl;
-    creatorProcessName = creatorProcess->GetProcessName();
-  } else {
-    creatorProcessName = "NoCreator";
-  }
-
-  // Get the particles previous and current interaction type (process)
-  // Process in the previous volume
-  G4VProcess *preProcess =
-      const_cast<G4VProcess *>(thePrePoint->GetProcessDefinedStep());
-  G4String preProcessName = "";
-
-  if (preProcess == 0)
-    preProcessName = "No preProcessName";
-  else
-    preProcessName =
-        preProcess->GetProcessName(); // Get the name of the previous process
-
-  // Process in the current volume
-  G4VProcess *postProcess =
-      const_cast<G4VProcess *>(thePostPoint->GetProcessDefinedStep());
-  G4String postProcessName = "";
-
-  if (postProcess == 0)
-    postProcessName = "No PostProcess";
-  else
-    postProcessName =
-        postProcess->GetProcessName(); // Get the name of the current process
-
-  G4String interactionType = ""; // Type of the interaction
-  G4String targetIsotope = "";   // H1 = 1.0, C12 = 2.0, O16 = 3.0, ...
-  // G4String particleName = "";    //  hadronic_particle_name = 1 if the
-  // interactiong particle is neutron, 0 otherwise Create a G4HadronicProcess
-  // object
-  G4HadronicProcess *hproc = dynamic_cast<G4HadronicProcess *>(postProcess);
-
-  if (!postProcess) {
-    std::cout << "postProcess is not good" << std::endl;
-  }
-  // Create a G4Isotope object (G4HadronicProcess::G4Isotope)
-  const G4Isotope *target = nullptr;
-  // G4Nucleus *TargetNucleus =  nullptr;
-
-  // Name of the target atom
-  // G4String targetName = "XXXX";
-  if ((hproc && (hproc->GetTargetIsotope()))) {
-    // If a hadronic process is underway for the corresponding particle, get the
-    // pointer for the target isotope
-    target = hproc->GetTargetIsotope();
-    // Get the name of the target for the hadronic process
-    // targetName = target->GetName();
-    // interactionType = "Hadronic";
-    interactionType = hproc->GetProcessName();
-    targetIsotope = target->GetName();
-  } else {
-    interactionType = postProcessName;
-    targetIsotope = thePostPVname;
-    // particleName = particle_name;
+  // energy deposit, the tallies are weighted by the track weight
+  G4double edepStep = aStep->GetTotalEnergyDeposit() / CLHEP::MeV;
+  const G4double weight = theTrack->GetWeight();
+  if (edepStep > 0.)
+    fEventAction->AddEdep(edepStep * weight);
+
+  // per-track summary: energy and path length in the monitor slabs
+  TrackSummaryRow *summary = fEventAction->GetTrackSummary();
+  if (summary != nullptr) {
+    PROFILE_STEP_SECTION(kTrackSummary);
+    const G4int layer = fDetector->GetAbsorberIndex(thePrePV);
+    if (layer >= 0) {
+      summary->fLayerEdep[layer] += edepStep;
+      summary->fLayerLength[layer] += aStep->GetStepLength() / CLHEP::mm;
+    }
   }
-  // ############################################################################################//
 
-  // ############################################################################################//
-  // #  EVENT ID #//
-  // ############################################################################################//
-  G4int evt = G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID();
-  // ############################################################################################//
-
-  // Create an instance of the analysis manager
-  G4AnalysisManager *analysisManager = G4AnalysisManager::Instance();
-
-  // Fill the ntuple only for neutrons created by inelastic scattering
-  if (fParticleName == "neutron" && interactionType == "neutronInelastic") {
-    // position of the photon created inside the detector
-    analysisManager->FillNtupleIColumn(0, 0, evt);
-    analysisManager->FillNtupleSColumn(0, 1, fParticleName);
-    analysisManager->FillNtupleDColumn(0, 2, posParticle[0] / mm);
-    analysisManager->FillNtupleDColumn(0, 3, posParticle[1] / mm);
-    analysisManager->FillNtupleDColumn(0, 4, posParticle[2] / mm);
-    analysisManager->FillNtupleSColumn(0, 5, interactionType);
-    analysisManager->FillNtupleSColumn(0, 6, targetIsotope);
-    // analysisManager->FillNtupleDColumn(0, 7, edepStep);
-    analysisManager->AddNtupleRow(0);
+  // deposit in the slab monitored by /run/beamOnUntil
+  const G4int monitoredSlab = fEventAction->GetMonitoredSlab();
+  if (monitoredSlab >= 0 && edepStep > 0. &&
+      fDetector->GetAbsorberIndex(thePrePV) == monitoredSlab)
+    fEventAction->AddTallyValue(edepStep * weight);
+
+  // compact trajectory, one point every `stride` steps
+  if (TrajectoryStore *trajectories = fEventAction->GetTrajectoryStore())
+    trajectories->AddStep(aStep);
+
+  // The silicon slabs and the boron converter are scored by their sensitive
+  // detectors (ScoringSD). Apart from the energy bookkeeping, the other steps
+  // only matter for the steps selected by the neutron capture filter and for
+  // particles leaving the world.
+  G4bool isCapture = false, exitsWorld = false;
+  {
+    PROFILE_STEP_SECTION(kFilters);
+    // The geometry may change between runs, the filters look up the volumes
+    // once per run
+    if (run->GetRunID() != fFilterRunID) {
+      fNeutronCaptureFilter.Prepare();
+      fExitWorldFilter.Prepare();
+      fFilterRunID = run->GetRunID();
+    }
+    isCapture = fNeutronCaptureFilter.Accept(aStep, processInfo->fCode);
+    exitsWorld = (thePrePV != nullptr && thePostPV == nullptr) &&
+                 save_flux_data == 1 &&
+                 fExitWorldFilter.Accept(aStep, processInfo->fCode);
   }
-
-  // energy deposit
-  //
-  // G4double edepStep = aStep->GetTotalEnergyDeposit() / CLHEP::keV;
-  G4double edepStep = aStep->GetTotalEnergyDeposit() / CLHEP::MeV;
-
-  // if (aStep->GetTrack()->GetNextVolume()) {
-  //   // // Stopping Power from input Table.
-
-  //   // Get the material at the pre-step point
-  //   G4Material *prematerial = thePrePoint->GetMaterial();
-  //   // Get the material at the post-step point
-  //   G4Material *postmaterial = thePostPoint->GetMaterial();
-  //   //   G4cout << "Next volume is  nullptr!" << G4endl;
-  //   //   return;
-  //   // }
-  //   // You can now use the material object, for example, to get its name
-  //   G4String materialName = postmaterial->GetName();
-  //   G4double density = postmaterial->GetDensity() / CLHEP::g;
-
-  //   // current step number
-  //   G4int StepNumber = aStep->GetTrack()->GetCurrentStepNumber();
-
-  //   // Get step length
-  //   G4double stepLength = aStep->GetStepLength() / CLHEP::cm2;
-  //   // G4cout << "Step length: " << stepLength << " mm" << G4endl;
-
-  //   // Kinetic energy of the particle after each step
-  //   G4double kinEnergy = theTrack->GetKineticEnergy();
-
-  //   G4double postKineticEnergy =
-  //   aStep->GetPostStepPoint()->GetKineticEnergy(); G4double preKineticEnergy
-  //   = aStep->GetPreStepPoint()->GetKineticEnergy();
-
-  //   G4double EDifference = (postKineticEnergy - preKineticEnergy) /
-  //   CLHEP::MeV;
-
-  //   // Get step length
-  //   G4double stepLength_ = aStep->GetStepLength() / CLHEP::mm;
-
-  //   G4EmCalculator emCalculator;
-  //   G4double dEdxTable = 0., dEdxFull = 0.;
-
-  //   if (particleType->GetPDGCharge() != 0.) {
-  //     dEdxTable =
-  //         emCalculator.GetDEDX(preKineticEnergy, particleType, postmaterial);
-  //     dEdxFull = emCalculator.ComputeTotalDEDX(preKineticEnergy,
-  //     particleType,
-  //                                              postmaterial);
-  //   }
-
-  //   G4double stopTable = dEdxTable / density;
-  //   G4double stopFull = dEdxFull / density;
-
-  //   // Stopping Power from simulation.
-  //   //
-  //   G4double meandEdx = edepStep / stepLength_;
-  //   G4double stopPower = meandEdx / density;
-
-  //   // // current step number
-  //   // G4int StepNumberr = aStep->GetTrack()->GetCurrentStepNumber();
-  //   // if ((thePostPVname == "physiSlab_AlongZ_1" ||
-  //   //      thePostPVname == "physiSlab_AlongY_1" ||
-  //   //      thePostPVname == "physiSlab_AlongX_1" ||
-  //   //      thePostPVname == "physiSlab_AlongY_2" ||
-  //   //      thePostPVname == "physiSlab_AlongX_2" ||
-  //   //      thePostPVname == "physiSlab_AlongZ_2")) {
-  //   //   std::cout << "Event Number: " << evt << std::endl;
-  //   //   std::cout << " Particle: " << fParticleName << std::endl;
-  //   //   std::cout << "Particle ID: " << part_ID << std::endl;
-  //   //   std::cout << "Particle Parent ID:  " << part_parent_ID << std::endl;
-  //   //   std::cout << "Step No: " << StepNumberr << std::endl;
-  //   //   std::cout << "Interaction Type: " << interactionType << std::endl;
-  //   //   std::cout << "Target Isotope: " << targetIsotope << std::endl;
-  //   //   std::cout << "Creator Process: " << creatorProcessName << std::endl;
-  //   //   std::cout << "Edep: " << edepStep << std::endl;
-  //   //   std::cout << "Ekin_post - Ekin_pre: " << EDifference << std::endl;
-  //   //   std::cout << "Int. Lenght (mm): " << aStep->GetStepLength() /
-  //   CLHEP::mm
-  //   //             << std::endl;
-  //   //   std::cout << "Prevoius Volume: " << thePrePVname << std::endl;
-  //   //   std::cout << "Current Volume:  " << thePostPVname << std::endl;
-  //   //   std::cout << std::endl;
-  //   // }
-
-  //   if ((thePostPVname == "physiSlab_AlongZ_1" ||
-  //        thePostPVname == "physiSlab_AlongY_1" ||
-  //        thePostPVname == "physiSlab_AlongX_1" ||
-  //        thePostPVname == "physiSlab_AlongY_2" ||
-  //        thePostPVname == "physiSlab_AlongX_2" ||
-  //        thePostPVname == "physiSlab_AlongZ_2")) {
-  //     std::cout << "Event: " << evt << "\nStep: " << StepNumber
-  //               << "\ncreatorProcessName: " << creatorProcessName
-  //               << "\npreProcessName: " << preProcessName
-  //               << "\npostProcessName: " << postProcessName
-  //               << "\nParticle: " << fParticleName
-  //               << "\nParentID: " << part_parent_ID
-  //               << "\nParticleID: " << part_ID << "\nPos: " << posParticle[0]
-  //               << "  " << posParticle[1] << " " << posParticle[2]
-  //               << "\nIntType: " << interactionType
-  //               << "\nTarget: " << targetIsotope
-  //               << "\nKinEn (MeV): " << kinEnergy
-  //               << "\npreKineticEnergy (MeV): " << preKineticEnergy
-  //               << "\npostKineticEnergy (MeV): " << postKineticEnergy
-  //               << "\nEdep (MeV): " << aStep->GetTotalEnergyDeposit()
-  //               << "\nS_Lenght(mm): " << aStep->GetStepLength() / CLHEP::mm
-  //               << "\nPre_vol: " << thePrePVname
-  //               << "\nPost_Vol: " << thePostPVname << std::endl;
-  //     std::cout << std::endl;
-
-  //     G4cout << "Mean dE/dx = " << meandEdx << " MeV/mm" << "\t(" <<
-  //     stopPower
-  //            << G4endl;
-
-  //     G4cout << "\nFrom formulas :" << G4endl;
-  //     G4cout << "   restricted dEdx = " << dEdxTable << "\t(" << stopTable
-  //            << ")" << G4endl;
-
-  //     G4cout << "   Full dEdx = " << dEdxFull << "\t(" << stopFull << ")"
-  //            << G4endl;
-  //     G4cout << "\n" << G4endl;
-  //     G4cout << "\n" << G4endl;
-  //   }
-  // }
-  // if (thePostPVname == "physiSlab_AlongZ_1" ||
-  //     thePostPVname == "physiSlab_AlongY_1" ||
-  //     thePostPVname == "physiSlab_AlongX_1" ||
-  //     thePostPVname == "physiSlab_AlongY_2" ||
-  //     thePostPVname == "physiSlab_AlongX_2" ||
-  //     thePostPVname == "physiSlab_AlongZ_2") {
-  //   std::cout << evt << ": Particle: " << fParticleName << "  "
-  //             << part_parent_ID << "  " << interactionType << "  "
-  //             << targetIsotope << "  " << "Creator: " << creatorProcessName
-  //             << "  " << aStep->GetTotalEnergyDeposit() / CLHEP::MeV << "  "
-  //             << (postKineticEnergy - preKineticEnergy) / CLHEP::MeV << "  "
-  //             << "Int. Lenght: " << aStep->GetStepLength() / CLHEP::mm << " "
-  //             << thePrePVname << " " << thePostPVname << std::endl;
-  //   std::cout << std::endl;
-  // }
-
-  // If the particle is interacted with the enriched boron slab.
-  if (thePostPVname == "B4C_enriched") {
-    // position of the photon created inside the detector
-    analysisManager->FillNtupleIColumn(1, 0, evt);
-    analysisManager->FillNtupleSColumn(1, 1, fParticleName);
-    analysisManager->FillNtupleIColumn(1, 2, part_parent_ID);
-    analysisManager->FillNtupleIColumn(1, 3, part_ID);
-    analysisManager->FillNtupleIColumn(1, 4, StepNumberr);
-    analysisManager->FillNtupleDColumn(1, 5, posParticle[0] / mm);
-    analysisManager->FillNtupleDColumn(1, 6, posParticle[1] / mm);
-    analysisManager->FillNtupleDColumn(1, 7, posParticle[2] / mm);
-    analysisManager->FillNtupleSColumn(1, 8, interactionType);
-    analysisManager->FillNtupleSColumn(1, 9, targetIsotope);
-    analysisManager->FillNtupleDColumn(1, 10, edepStep);
-    analysisManager->FillNtupleSColumn(1, 11, creatorProcessName);
-    analysisManager->AddNtupleRow(1);
+  if (!isCapture && !exitsWorld && !print_step_info)
+    return false;
+
+  const G4ThreeVector &posParticle = thePostPoint->GetPosition();
+  const G4VProcess *postProcess = thePostPoint->GetProcessDefinedStep();
+  G4bool recorded = false;
+
+  // By default, neutrons ending in an inelastic interaction
+  if (isCapture) {
+    PROFILE_STEP_SECTION(kNeutronCapture);
+    NeutronCaptureRow row;
+    row.fEvent = CurrentEventID();
+    row.fParticleName = &particleType->GetParticleName();
+    row.fX = posParticle[0] / mm;
+    row.fY = posParticle[1] / mm;
+    row.fZ = posParticle[2] / mm;
+    row.fInteractionType = &StepNames::Process(postProcess);
+    row.fTargetIsotope = &StepNames::Target(aStep);
+    row.fAncestry = TrackInformation::GetAncestry(theTrack);
+    row.fWeight = weight;
+    fEventAction->StageNeutronCapture(row);
+    recorded = true;
   }
 
-  // if (!step->GetTrack()->GetNextVolume())
   //  Check if the particle is leaving the world volume
   //  Save the information of the particle exiting the world volume
-  if (thePrePV != nullptr && thePostPV == nullptr && save_flux_data == 1) {
-    // G4cout << "Particle exited the world volume." << G4endl;
-    analysisManager->FillNtupleIColumn(6, 0, evt);
-    analysisManager->FillNtupleSColumn(6, 1, fParticleName);
-    analysisManager->FillNtupleIColumn(6, 2, part_parent_ID);
-    analysisManager->FillNtupleIColumn(6, 3, part_ID);
-    analysisManager->FillNtupleIColumn(6, 4, StepNumberr);
-    analysisManager->FillNtupleDColumn(6, 5, posParticle[0] / mm);
-    analysisManager->FillNtupleDColumn(6, 6, posParticle[1] / mm);
-    analysisManager->FillNtupleDColumn(6, 7, posParticle[2] / mm);
-    analysisManager->FillNtupleDColumn(
-        6, 8, aStep->GetPreStepPoint()->GetKineticEnergy() / MeV);
-    analysisManager->FillNtupleSColumn(6, 9, interactionType);
-    analysisManager->FillNtupleSColumn(6, 10, targetIsotope);
-    analysisManager->FillNtupleSColumn(6, 11, creatorProcessName);
-    analysisManager->FillNtupleSColumn(6, 12, PVatVertexname);
-
-    analysisManager->AddNtupleRow(6);
+  if (exitsWorld) {
+    PROFILE_STEP_SECTION(kExitWorld);
+    ExitWorldRow row;
+    row.fEvent = CurrentEventID();
+    row.fParticleName = &particleType->GetParticleName();
+    row.fParentID = theTrack->GetParentID();
+    row.fParticleID = theTrack->GetTrackID();
+    row.fStepNumber = theTrack->GetCurrentStepNumber();
+    row.fX = posParticle[0] / mm;
+    row.fY = posParticle[1] / mm;
+    row.fZ = posParticle[2] / mm;
+    row.fKinEnergy = thePrePoint->GetKineticEnergy() / MeV;
+    row.fInteractionType = &StepNames::Process(postProcess);
+    row.fTargetIsotope = &StepNames::Target(aStep);
+    row.fCreatorProcessName = &StepNames::Creator(theTrack);
+    row.fVertexVolumeName = &theTrack->GetLogicalVolumeAtVertex()->GetName();
+    row.fAncestry = TrackInformation::GetAncestry(theTrack);
+    row.fWeight = weight;
+    fEventAction->StageExitWorld(row);
+    recorded = true;
   }
+
   // ###############################################################################################//
   // Print the particles step information
   // #############################################################################################//
-  G4double postKineticEnergy = aStep->GetPostStepPoint()->GetKineticEnergy();
-  G4double preKineticEnergy = aStep->GetPreStepPoint()->GetKineticEnergy();
-
-  G4double EDifference = (postKineticEnergy - preKineticEnergy) / CLHEP::MeV;
-
-  print_step_info = 0;
   if (print_step_info) {
-    std::cout << "Event Number: " << evt << std::endl;
-    std::cout << "Particle: " << fParticleName << std::endl;
-    std::cout << "Particle ID: " << part_ID << std::endl;
-    std::cout << "Particle Parent ID:  " << part_parent_ID << std::endl;
-    std::cout << "Step No: " << StepNumberr << std::endl;
-    std::cout << "Interaction Type: " << interactionType << std::endl;
-    std::cout << "Target Isotope: " << targetIsotope << std::endl;
-    std::cout << "Creator Process: " << creatorProcessName << std::endl;
+    PROFILE_STEP_SECTION(kPrintStep);
+    G4double EDifference =
+        (thePostPoint->GetKineticEnergy() - thePrePoint->GetKineticEnergy()) /
+        CLHEP::MeV;
+    std::cout << "Event Number: " << CurrentEventID() << std::endl;
+    std::cout << "Particle: " << particleType->GetParticleName() << std::endl;
+    std::cout << "Particle ID: " << theTrack->GetTrackID() << std::endl;
+    std::cout << "Particle Parent ID:  " << theTrack->GetParentID()
+              << std::endl;
+    std::cout << "Step No: " << theTrack->GetCurrentStepNumber() << std::endl;
+    std::cout << "Interaction Type: " << StepNames::Process(postProcess)
+              << std::endl;
+    std::cout << "Target Isotope: " << StepNames::Target(aStep) << std::endl;
+    std::cout << "Creator Process: " << StepNames::Creator(theTrack)
+              << std::endl;
     std::cout << "Edep: " << edepStep << std::endl;
     std::cout << "Ekin_post - Ekin_pre: " << EDifference << std::endl;
     std::cout << "Int. Lenght (mm): " << aStep->GetStepLength() / CLHEP::mm
               << std::endl;
-    std::cout << "Prevoius Volume: " << thePrePVname << std::endl;
-    std::cout << "Current Volume:  " << thePostPVname << std::endl;
-    std::cout << " Vertx Vol:  " << PVatVertexname << std::endl;
+    std::cout << "Prevoius Volume: " << StepNames::Volume(thePrePV)
+              << std::endl;
+    std::cout << "Current Volume:  " << StepNames::Volume(thePostPV)
+              << std::endl;
+    std::cout << " Vertx Vol:  "
+              << theTrack->GetLogicalVolumeAtVertex()->GetName() << std::endl;
     std::cout << std::endl;
   }
   // #############################################################################################//
 
-  //  // If no energy deposit, return1
-  if (edepStep <= 0.)
-    return;
-  fEventAction->AddEdep(edepStep);
-  //-------------------------------------------------------------------------//
-
-  // Save the eergy deposition data in the silicon slabs
-  if (save_silicon_data == 1 && aStep->GetTrack()->GetNextVolume()) {
-
-    // // Stopping Power from input Table.
-
-    // Get the material at the pre-step point
-    G4Material *prematerial = thePrePoint->GetMaterial();
-    // Get the material at the post-step point
-    G4Material *postmaterial = thePostPoint->GetMaterial();
-    //   G4cout << "Next volume is  nullptr!" << G4endl;
-    //   return;
-    // }
-    // You can now use the material object, for example, to get its name
-    G4String materialName = postmaterial->GetName();
-    G4double density = postmaterial->GetDensity() / (g / cm3);
-
-    // Get step length
-    G4double stepLength = aStep->GetStepLength() / cm2;
-    // G4cout << "Step length: " << stepLength << " mm" << G4endl;
-
-    // Kinetic energy of the particle after each step
-    G4double kinEnergy = theTrack->GetKineticEnergy() * MeV;
-
-    G4double postKineticEnergy =
-        aStep->GetPostStepPoint()->GetKineticEnergy() * MeV;
-    G4double preKineticEnergy =
-        aStep->GetPreStepPoint()->GetKineticEnergy() * MeV;
-
-    // current step number
-    G4int StepNumber = aStep->GetTrack()->GetCurrentStepNumber();
-
-    G4EmCalculator emCalculator;
-    G4double dEdxTable = 0., dEdxFull = 0.;
-
-    if (particleType->GetPDGCharge() != 0.) {
-      dEdxTable =
-          emCalculator.GetDEDX(preKineticEnergy, particleType, postmaterial);
-      dEdxFull = emCalculator.ComputeTotalDEDX(preKineticEnergy, particleType,
-                                               postmaterial);
-    }
-    G4double stopTable = dEdxTable / density;
-    G4double stopFull = dEdxFull / density;
-
-    // Stopping Power from simulation.
-    //
-    G4double meandEdx = edepStep / stepLength;
-    G4double stopPower = meandEdx / density;
-
-    // Deposition in the silicon slabs
-    //********************************************************************
-    if ((stepLength != 0) && thePostPVname == "physiSlab_AlongY_1") {
-      analysisManager->FillNtupleIColumn(2, 0, evt);
-      analysisManager->FillNtupleSColumn(2, 1, fParticleName);
-      analysisManager->FillNtupleIColumn(2, 2, part_parent_ID);
-      analysisManager->FillNtupleIColumn(2, 3, part_ID);
-      analysisManager->FillNtupleIColumn(2, 4, StepNumber);
-      analysisManager->FillNtupleDColumn(2, 5, posParticle[0] / mm);
-      analysisManager->FillNtupleDColumn(2, 6, posParticle[1] / mm);
-      analysisManager->FillNtupleDColumn(2, 7, posParticle[2] / mm);
-      analysisManager->FillNtupleSColumn(2, 8, interactionType);
-      analysisManager->FillNtupleSColumn(2, 9, targetIsotope);
-      analysisManager->FillNtupleDColumn(2, 10, edepStep / MeV);
-      analysisManager->FillNtupleDColumn(
-          2, 11, stopTable / (CLHEP::MeV * CLHEP::cm2 / CLHEP::g));
-      analysisManager->FillNtupleDColumn(
-          2, 12, stopFull / (CLHEP::MeV * CLHEP::cm2 / CLHEP::g));
-      analysisManager->FillNtupleDColumn(2, 13,
-                                         meandEdx / (CLHEP::MeV / CLHEP::cm));
-      analysisManager->FillNtupleDColumn(
-          2, 14, stopPower / (CLHEP::MeV * CLHEP::cm2 / CLHEP::g));
-      analysisManager->FillNtupleSColumn(2, 15, creatorProcessName);
-      analysisManager->FillNtupleSColumn(2, 16, PVatVertexname);
-
-      analysisManager->AddNtupleRow(2);
-    }
-    //******************************************************************** */
-
-    if ((stepLength != 0) && thePostPVname == "physiSlab_AlongY_2") {
-      analysisManager->FillNtupleIColumn(3, 0, evt);
-      analysisManager->FillNtupleSColumn(3, 1, fParticleName);
-      analysisManager->FillNtupleIColumn(3, 2, part_parent_ID);
-      analysisManager->FillNtupleIColumn(3, 3, part_ID);
-      analysisManager->FillNtupleIColumn(3, 4, StepNumber);
-      analysisManager->FillNtupleDColumn(3, 5, posParticle[0] / mm);
-      analysisManager->FillNtupleDColumn(3, 6, posParticle[1] / mm);
-      analysisManager->FillNtupleDColumn(3, 7, posParticle[2] / mm);
-      analysisManager->FillNtupleSColumn(3, 8, interactionType);
-      analysisManager->FillNtupleSColumn(3, 9, targetIsotope);
-      analysisManager->FillNtupleDColumn(3, 10, edepStep / MeV);
-      analysisManager->FillNtupleDColumn(
-          3, 11, stopTable / (CLHEP::MeV * CLHEP::cm2 / CLHEP::g));
-      analysisManager->FillNtupleDColumn(
-          3, 12, stopFull / (CLHEP::MeV * CLHEP::cm2 / CLHEP::g));
-      analysisManager->FillNtupleDColumn(3, 13,
-                                         meandEdx / (CLHEP::MeV / CLHEP::cm));
-      analysisManager->FillNtupleDColumn(
-          3, 14, stopPower / (CLHEP::MeV * CLHEP::cm2 / CLHEP::g));
-      analysisManager->FillNtupleSColumn(3, 15, creatorProcessName);
-      analysisManager->FillNtupleSColumn(3, 16, PVatVertexname);
-
-      analysisManager->AddNtupleRow(3);
-    }
-    //******************************************************************** */
-
-    if ((stepLength != 0) && thePostPVname == "physiSlab_AlongZ_1") {
-      analysisManager->FillNtupleIColumn(4, 0, evt);
-      analysisManager->FillNtupleSColumn(4, 1, fParticleName);
-      analysisManager->FillNtupleIColumn(4, 2, part_parent_ID);
-      analysisManager->FillNtupleIColumn(4, 3, part_ID);
-      analysisManager->FillNtupleIColumn(4, 4, StepNumber);
-      analysisManager->FillNtupleDColumn(4, 5, posParticle[0] / mm);
-      analysisManager->FillNtupleDColumn(4, 6, posParticle[1] / mm);
-      analysisManager->FillNtupleDColumn(4, 7, posParticle[2] / mm);
-      analysisManager->FillNtupleSColumn(4, 8, interactionType);
-      analysisManager->FillNtupleSColumn(4, 9, targetIsotope);
-      analysisManager->FillNtupleDColumn(4, 10, edepStep / MeV);
-      analysisManager->FillNtupleDColumn(
-          4, 11, stopTable / (CLHEP::MeV * CLHEP::cm2 / CLHEP::g));
-      analysisManager->FillNtupleDColumn(
-          4, 12, stopFull / (CLHEP::MeV * CLHEP::cm2 / CLHEP::g));
-      analysisManager->FillNtupleDColumn(4, 13,
-                                         meandEdx / (CLHEP::MeV / CLHEP::cm));
-      analysisManager->FillNtupleDColumn(
-          4, 14, stopPower / (CLHEP::MeV * CLHEP::cm2 / CLHEP::g));
-      analysisManager->FillNtupleSColumn(4, 15, creatorProcessName);
-      analysisManager->FillNtupleSColumn(4, 16, PVatVertexname);
-
-      analysisManager->AddNtupleRow(4);
-    }
-    //******************************************************************** */
-
-    if ((stepLength != 0) && thePostPVname == "physiSlab_AlongZ_2") {
-      analysisManager->FillNtupleIColumn(5, 0, evt);
-      analysisManager->FillNtupleSColumn(5, 1, fParticleName);
-      analysisManager->FillNtupleIColumn(5, 2, part_parent_ID);
-      analysisManager->FillNtupleIColumn(5, 3, part_ID);
-      analysisManager->FillNtupleIColumn(5, 4, StepNumber);
-      analysisManager->FillNtupleDColumn(5, 5, posParticle[0] / mm);
-      analysisManager->FillNtupleDColumn(5, 6, posParticle[1] / mm);
-      analysisManager->FillNtupleDColumn(5, 7, posParticle[2] / mm);
-      analysisManager->FillNtupleSColumn(5, 8, interactionType);
-      analysisManager->FillNtupleSColumn(5, 9, targetIsotope);
-      analysisManager->FillNtupleDColumn(5, 10, edepStep / MeV);
-      analysisManager->FillNtupleDColumn(
-          5, 11, stopTable / (CLHEP::MeV * CLHEP::cm2 / CLHEP::g));
-      analysisManager->FillNtupleDColumn(
-          5, 12, stopFull / (CLHEP::MeV * CLHEP::cm2 / CLHEP::g));
-      analysisManager->FillNtupleDColumn(5, 13,
-                                         meandEdx / (CLHEP::MeV / CLHEP::cm));
-      analysisManager->FillNtupleDColumn(
-          5, 14, stopPower / (CLHEP::MeV * CLHEP::cm2 / CLHEP::g));
-      analysisManager->FillNtupleSColumn(5, 15, creatorProcessName);
-      analysisManager->FillNtupleSColumn(5, 16, PVatVertexname);
-
-      analysisManager->AddNtupleRow(5);
-    }
-    // if (meandEdx != 0 && (thePostPVname == "physiSlab_AlongZ_1" ||
-    //                       thePostPVname == "physiSlab_AlongY_1" ||
-    //                       thePostPVname == "physiSlab_AlongX_1" ||
-    //                       thePostPVname == "physiSlab_AlongY_2" ||
-    //                       thePostPVname == "physiSlab_AlongX_2" ||
-    //                       thePostPVname == "physiSlab_AlongZ_2")) {
-    //   std::cout << "Event: " << evt << "\nStep: " << StepNumber
-    //             << "\ncreatorProcessName: " << creatorProcessName
-    //             << "\npreProcessName: " << preProcessName
-    //             << "\npostProcessName: " << postProcessName
-    //             << "\nParticle: " << fParticleName
-    //             << "\nParentID: " << part_parent_ID
-    //             << "\nParticleID: " << part_ID << "\nPos: " <<
-    // posParticle[0]
-    //             << "  " << posParticle[1] << " " << posParticle[2]
-    //             << "\nIntType: " << interactionType
-    //             << "\nTarget: " << targetIsotope
-    //             << "\nKinEn (MeV): " << kinEnergy
-    //             << "\npreKineticEnergy (MeV): " << preKineticEnergy
-    //             << "\npostKineticEnergy (MeV): " << postKineticEnergy
-    //             << "\nEdep (MeV): " << aStep->GetTotalEnergyDeposit()
-    //             << "\nS_Lenght(mm): " << aStep->GetStepLength() /
-    // CLHEP::mm
-    //             << "\nPre_vol: " << thePrePVname
-    //             << "\nPost_Vol: " << thePostPVname << std::endl;
-    //   std::cout << std::endl;
-
-    //   G4cout << "Mean dE/dx = " << meandEdx / (CLHEP::MeV / CLHEP::cm)
-    //          << " MeV/cm" << "\t("
-    //          << stopPower / (CLHEP::MeV * CLHEP::cm2 / CLHEP::g)
-    //          << " MeV*cm2/g)" << G4endl;
-
-    //   G4cout << "\n From formulas :" << G4endl;
-    //   G4cout << "   restricted dEdx = " << dEdxTable / (CLHEP::MeV /
-    //   CLHEP::cm)
-    //          << " MeV/cm" << "\t("
-    //          << stopTable / (CLHEP::MeV * CLHEP::cm2 / CLHEP::g)
-    //          << " MeV*cm2/g)" << G4endl;
-
-    //   G4cout << "   full dEdx       = " << dEdxFull / (CLHEP::MeV /
-    //   CLHEP::cm)
-    //          << " MeV/cm" << "\t("
-    //          << stopFull / (CLHEP::MeV * CLHEP::cm2 / CLHEP::g) << "
-    //          MeV*cm2/g)"
-    //          << G4endl;
-    //   G4cout << "\n" << G4endl;
-    //   G4cout << "\n" << G4endl;
-    // }
+  return recorded;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SteppingAction::TagSecondaries(
+    const G4Step *aStep, const ProcessInfo &processInfo,
+    const std::vector<const G4Track *> &secondaries) {
+  // 10B(n,alpha)7Li is a neutron inelastic reaction for the HP models
+  G4bool isB10Capture = false;
+  if (processInfo.fHadronic != nullptr &&
+      (processInfo.fSubType == fHadronInelastic ||
+       processInfo.fSubType == fCapture)) {
+    const G4Isotope *target = processInfo.fHadronic->GetTargetIsotope();
+    isB10Capture =
+        (target != nullptr && target->GetZ() == 5 && target->GetN() == 10);
   }
-  //-------------------------------------------------------------------------//
-
-  // G4cout << fParticleName << " " << part_parent_ID << "  " << part_ID
-  //        << " -----> Mean dE/dx = " << meandEdx / (MeV / cm) << " MeV/cm"
-  //        << "\t(" << stopPower / (MeV * cm2 / g) << " MeV*cm2/g)" << G4endl;
-
-  // G4cout << fParticleName << " " << part_parent_ID << "  " << part_ID << "  "
-  //        << StepNumber << "  " << materialName
-  //        << "\n From formulas :" << G4endl;
-  // G4cout << "   restricted dEdx = " << dEdxTable / (CLHEP::MeV / CLHEP::cm)
-  //        << " MeV/cm" << "\t("
-  //        << stopTable / (CLHEP::MeV * CLHEP::cm2 / CLHEP::g) << " MeV*cm2/g)"
-  //        << G4endl;
-
-  // std::cout << evt << ": Particle: " << fParticleName << "  " <<
-  // part_parent_ID
-  //           << "  " << part_ID << "  " << posParticle[0] << "  "
-  //           << posParticle[1] << " " << posParticle[2] << "  "
-  //           << interactionType << "  " << targetIsotope << "  "
-  //           << aStep->GetTotalEnergyDeposit() / CLHEP::keV << "  "
-  //           << "step Lenght: " << aStep->GetStepLength() << "  " <<
-  //           thePrePVname << " "
-  //           << thePostPVname << std::endl;
-  // std::cout << std::endl;
+  const G4bool isRadioactiveDecay = (processInfo.fCategory == fDecay &&
+                                     processInfo.fSubType == DECAY_Radioactive);
+  const G4int layer = fDetector->GetAbsorberIndex(
+      aStep->GetPreStepPoint()->GetPhysicalVolume());
+
+  // All the secondaries of a step share their ancestry
+  const G4int ancestry = TrackInformation::SecondaryAncestry(
+      aStep->GetTrack(), layer, isB10Capture, isRadioactiveDecay);
+  for (const G4Track *secondary : secondaries)
+    secondary->SetUserInformation(new TrackInformation(ancestry));
 }
 
 //*********************************************************************************//
@@ -680,7 +304,29 @@ void SteppingAction::SaveSiliconEdepData(G4int val) {
            << val << " is out of range. Command refused" << G4endl;
     return;
   }
-  save_silicon_data = val;
+  // The silicon hits are written at end of event
+  fEventAction->SaveSiliconEdepData(val);
+}
+void SteppingAction::SaveSiliconSegmentData(G4int val) {
+  if (val < 0) {
+    G4cout << "\n --->warning from Save the silicon segments: value should be "
+              "greater or equal to zero - Value: "
+           << val << " is out of range. Command refused" << G4endl;
+    return;
+  }
+  // One row per track passage through a slab, written at end of event
+  fEventAction->SaveSiliconSegmentData(val);
+  ScoringSD::SetSaveSegments(val == 1);
+}
+void SteppingAction::SaveTrackSummaryData(G4int val) {
+  if (val < 0) {
+    G4cout << "\n --->warning from Save the track summary: value should be "
+              "greater or equal to zero - Value: "
+           << val << " is out of range. Command refused" << G4endl;
+    return;
+  }
+  // One row per track, written at end of track
+  fEventAction->SaveTrackSummaryData(val);
 }
 void SteppingAction::SaveParticleFluxData(G4int val) {
   // change the transverse size
@@ -693,4 +339,71 @@ void SteppingAction::SaveParticleFluxData(G4int val) {
   }
   save_flux_data = val;
 }
+void SteppingAction::SetDedxCheckTolerance(G4double val) {
+  // the stopping powers are computed when the silicon hits are written
+  if (val < 0.) {
+    G4cout << "\n --->warning from the dE/dx check: tolerance should be "
+              "greater or equal to zero - Value: "
+           << val << " is out of range. Command refused" << G4endl;
+    return;
+  }
+  fEventAction->GetStoppingPowerCache().SetCheckTolerance(val);
+}
+void SteppingAction::SetCaptureTrigger(G4int val) {
+  // the triggers are evaluated by the EventAction at end of event
+  if (val < 0) {
+    G4cout << "\n --->warning from the capture trigger: value should be "
+              "greater or equal to zero - Value: "
+           << val << " is out of range. Command refused" << G4endl;
+    return;
+  }
+  fEventAction->SetCaptureTrigger(val > 0);
+}
+void SteppingAction::SetEdepTrigger(const G4String &volumeName,
+                                    G4double threshold) {
+  if (threshold < 0.) {
+    G4cout << "\n --->warning from the edep trigger: threshold should be "
+              "greater or equal to zero - Value: "
+           << threshold << " is out of range. Command refused" << G4endl;
+    return;
+  }
+  for (G4int v = 0; v < kNbScoringVolumes; ++v) {
+    const auto volume = static_cast<ScoringVolume>(v);
+    if (volumeName == ScoringSD::GetDetectorName(volume)) {
+      fEventAction->SetEdepTrigger(volume, threshold);
+      return;
+    }
+  }
+  G4cout << "\n --->warning from the edep trigger: " << volumeName
+         << " is not a scoring volume. Command refused" << G4endl;
+}
+void SteppingAction::ClearTriggers() { fEventAction->ClearTriggers(); }
+void SteppingAction::SetRecordingFilter(const G4String &ntupleName,
+                                        const G4String &expression) {
+  StepFilter *filter = nullptr;
+  if (ntupleName == "neutronCapture")
+    filter = &fNeutronCaptureFilter;
+  else if (ntupleName == "exitWorld")
+    filter = &fExitWorldFilter;
+  if (filter == nullptr) {
+    G4cout << "\n --->warning from the recording filter: " << ntupleName
+           << " has no filter. Command refused" << G4endl;
+    return;
+  }
+  G4String error;
+  if (!filter->Compile(expression, error)) {
+    G4cout << "\n --->warning from the " << ntupleName
+           << " filter: " << error << " in \"" << expression
+           << "\". Command refused" << G4endl;
+    return;
+  }
+  // resolve the volume names at the next step
+  fFilterRunID = -1;
+}
+void SteppingAction::ListRecordingFilters() {
+  G4cout << "\n Recording filters:"
+         << "\n   neutronCapture: " << fNeutronCaptureFilter.GetExpression()
+         << "\n   exitWorld:      " << fExitWorldFilter.GetExpression()
+         << G4endl;
+}
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
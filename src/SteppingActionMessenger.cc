@@ -41,13 +41,19 @@
 
 #include "SteppingActionMessenger.hh"
 
+#include "ScoringSD.hh"
 #include "SteppingAction.hh"
 
+#include "G4UIcmdWithADouble.hh"
 #include "G4UIcmdWithAString.hh"
 #include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithoutParameter.hh"
 #include "G4UIdirectory.hh"
+#include "G4UIparameter.hh"
 #include "globals.hh"
 
+#include <sstream>
+
 SteppingActionMessenger::SteppingActionMessenger(SteppingAction *SA)
     : steppingAction(SA) {
 
@@ -62,6 +68,22 @@ SteppingActionMessenger::SteppingActionMessenger(SteppingAction *SA)
   SaveSiliconData->AvailableForStates(G4State_PreInit, G4State_Idle);
   SaveSiliconData->SetToBeBroadcasted(false);
 
+  SaveSiliconSegments =
+      new G4UIcmdWithAnInteger("/stepping/saveSiliconSegments", this);
+  SaveSiliconSegments->SetGuidance(
+      "Save one row per track passage through a silicon slab.");
+  SaveSiliconSegments->SetParameterName("saveSilSegments", false);
+  SaveSiliconSegments->AvailableForStates(G4State_PreInit, G4State_Idle);
+  SaveSiliconSegments->SetToBeBroadcasted(true);
+
+  SaveTrackSummary =
+      new G4UIcmdWithAnInteger("/stepping/saveTrackSummary", this);
+  SaveTrackSummary->SetGuidance(
+      "Save one row per track to Track_Summary (vertex, fate, slab deposits).");
+  SaveTrackSummary->SetParameterName("saveTrackSummary", false);
+  SaveTrackSummary->AvailableForStates(G4State_PreInit, G4State_Idle);
+  SaveTrackSummary->SetToBeBroadcasted(true);
+
   SaveFluxData = new G4UIcmdWithAnInteger("/stepping/saveFluxData", this);
   SaveFluxData->SetGuidance(
       "Save the particles emerging from the world volume.");
@@ -69,13 +91,110 @@ SteppingActionMessenger::SteppingActionMessenger(SteppingAction *SA)
   // SaveFluxData->SetRange("saveSilData=>0");
   SaveFluxData->AvailableForStates(G4State_PreInit, G4State_Idle);
   SaveFluxData->SetToBeBroadcasted(false);
+
+  DedxCheckTolerance =
+      new G4UIcmdWithADouble("/stepping/dedxCheckTolerance", this);
+  DedxCheckTolerance->SetGuidance(
+      "Compare the cached stopping powers with G4EmCalculator.");
+  DedxCheckTolerance->SetGuidance(
+      "Relative deviations above the tolerance are reported, 0 disables.");
+  DedxCheckTolerance->SetParameterName("tolerance", false);
+  DedxCheckTolerance->SetRange("tolerance>=0.");
+  DedxCheckTolerance->AvailableForStates(G4State_PreInit, G4State_Idle);
+  DedxCheckTolerance->SetToBeBroadcasted(true);
+
+  TriggerOnCapture =
+      new G4UIcmdWithAnInteger("/stepping/triggerOnCapture", this);
+  TriggerOnCapture->SetGuidance(
+      "Write only events with a neutron capture in the boron converter.");
+  TriggerOnCapture->SetGuidance(
+      "Events are written if any of the triggers fires.");
+  TriggerOnCapture->SetParameterName("trigger", false);
+  TriggerOnCapture->AvailableForStates(G4State_PreInit, G4State_Idle);
+  TriggerOnCapture->SetToBeBroadcasted(true);
+
+  TriggerEdep = new G4UIcommand("/stepping/triggerEdep", this);
+  TriggerEdep->SetGuidance(
+      "Write only events depositing more than a threshold in a volume.");
+  TriggerEdep->SetGuidance(
+      "Events are written if any of the triggers fires.");
+  TriggerEdep->SetGuidance("  scoring volume name");
+  TriggerEdep->SetGuidance("  threshold (with unit) : t>=0.");
+  //
+  G4UIparameter *volumePrm = new G4UIparameter("volume", 's', false);
+  volumePrm->SetGuidance("scoring volume name");
+  G4String volumeList;
+  for (G4int v = 0; v < kNbScoringVolumes; ++v) {
+    volumeList += ScoringSD::GetDetectorName(static_cast<ScoringVolume>(v));
+    volumeList += " ";
+  }
+  volumePrm->SetParameterCandidates(volumeList);
+  TriggerEdep->SetParameter(volumePrm);
+  //
+  G4UIparameter *thresholdPrm = new G4UIparameter("threshold", 'd', false);
+  thresholdPrm->SetGuidance("energy deposit threshold");
+  thresholdPrm->SetParameterRange("threshold>=0.");
+  TriggerEdep->SetParameter(thresholdPrm);
+  //
+  G4UIparameter *unitPrm = new G4UIparameter("unit", 's', false);
+  unitPrm->SetGuidance("unit of threshold");
+  G4String unitList = G4UIcommand::UnitsList(G4UIcommand::CategoryOf("keV"));
+  unitPrm->SetParameterCandidates(unitList);
+  TriggerEdep->SetParameter(unitPrm);
+  TriggerEdep->AvailableForStates(G4State_PreInit, G4State_Idle);
+  TriggerEdep->SetToBeBroadcasted(true);
+
+  ClearTriggers = new G4UIcmdWithoutParameter("/stepping/clearTriggers", this);
+  ClearTriggers->SetGuidance("Remove all triggers, every event is written.");
+  ClearTriggers->AvailableForStates(G4State_PreInit, G4State_Idle);
+  ClearTriggers->SetToBeBroadcasted(true);
+
+  fFilterDir = new G4UIdirectory("/stepping/filter/");
+  fFilterDir->SetGuidance("Selection of the steps written to the ntuples.");
+  fFilterDir->SetGuidance("Expressions over particle, volume, process, energy "
+                          "and edep, e.g.");
+  fFilterDir->SetGuidance(
+      "  particle == neutron && volume == B4C_enriched && energy < 1 eV");
+
+  FilterNeutronCapture =
+      new G4UIcmdWithAString("/stepping/filter/neutronCapture", this);
+  FilterNeutronCapture->SetGuidance(
+      "Select the steps written to NeutronCapture_Data.");
+  FilterNeutronCapture->SetGuidance(
+      "Default: particle == neutron && process == neutronInelastic");
+  FilterNeutronCapture->SetParameterName("expression", false);
+  FilterNeutronCapture->AvailableForStates(G4State_PreInit, G4State_Idle);
+  FilterNeutronCapture->SetToBeBroadcasted(true);
+
+  FilterExitWorld = new G4UIcmdWithAString("/stepping/filter/exitWorld", this);
+  FilterExitWorld->SetGuidance(
+      "Select the particles written to Particles_Exit_World.");
+  FilterExitWorld->SetGuidance("Default: all");
+  FilterExitWorld->SetParameterName("expression", false);
+  FilterExitWorld->AvailableForStates(G4State_PreInit, G4State_Idle);
+  FilterExitWorld->SetToBeBroadcasted(true);
+
+  ListFilters = new G4UIcmdWithoutParameter("/stepping/filter/list", this);
+  ListFilters->SetGuidance("Print the recording filters.");
+  ListFilters->AvailableForStates(G4State_PreInit, G4State_Idle);
+  ListFilters->SetToBeBroadcasted(true);
 }
 
 // ooooooooooooooooooooooooooooooooooooooooo
 SteppingActionMessenger::~SteppingActionMessenger() {
 
   delete SaveSiliconData;
+  delete SaveSiliconSegments;
   delete SaveFluxData;
+  delete SaveTrackSummary;
+  delete DedxCheckTolerance;
+  delete TriggerOnCapture;
+  delete TriggerEdep;
+  delete ClearTriggers;
+  delete FilterNeutronCapture;
+  delete FilterExitWorld;
+  delete ListFilters;
+  delete fFilterDir;
   // delete fSteppingDir;
 }
 
@@ -88,7 +207,52 @@ void SteppingActionMessenger::SetNewValue(G4UIcommand *command,
         SaveSiliconData->GetNewIntValue(newValue));
   }
 
+  if (command == SaveSiliconSegments) {
+    steppingAction->SaveSiliconSegmentData(
+        SaveSiliconSegments->GetNewIntValue(newValue));
+  }
+
   if (command == SaveFluxData) {
     steppingAction->SaveParticleFluxData(SaveFluxData->GetNewIntValue(newValue));
   }
+
+  if (command == SaveTrackSummary) {
+    steppingAction->SaveTrackSummaryData(
+        SaveTrackSummary->GetNewIntValue(newValue));
+  }
+
+  if (command == DedxCheckTolerance) {
+    steppingAction->SetDedxCheckTolerance(
+        DedxCheckTolerance->GetNewDoubleValue(newValue));
+  }
+
+  if (command == TriggerOnCapture) {
+    steppingAction->SetCaptureTrigger(
+        TriggerOnCapture->GetNewIntValue(newValue));
+  }
+
+  if (command == TriggerEdep) {
+    G4String volume, unit;
+    G4double threshold;
+    std::istringstream is(newValue);
+    is >> volume >> threshold >> unit;
+    threshold *= G4UIcommand::ValueOf(unit);
+    steppingAction->SetEdepTrigger(volume, threshold);
+  }
+
+  if (command == ClearTriggers) {
+    steppingAction->ClearTriggers();
+  }
+
+  if (command == FilterNeutronCapture) {
+    steppingAction->SetRecordingFilter("neutronCapture", newValue);
+  }
+
+  if (command == FilterExitWorld) {
+    steppingAction->SetRecordingFilter("exitWorld", newValue);
+  }
+
+  if (command == ListFilters) {
+    steppingAction->ListRecordingFilters();
+  }
 }
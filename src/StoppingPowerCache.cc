@@ -0,0 +1,123 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file StoppingPowerCache.cc
+/// \brief Implementation of the StoppingPowerCache class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "StoppingPowerCache.hh"
+
+#include "G4Material.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+// Kinetic energy grid, 1 keV - 10 GeV
+const G4double kEmin = 1. * keV;
+const G4double kEmax = 10. * GeV;
+const G4int kBinsPerDecade = 50;
+const G4int kNbBins = 7 * kBinsPerDecade;
+const G4double kLogEmin = std::log(kEmin);
+const G4double kInvLogStep = kBinsPerDecade / std::log(10.);
+
+// Reports of the accuracy check printed per thread
+const G4int kMaxCheckWarnings = 10;
+}  // namespace
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StoppingPowerCache::GetDEDX(G4double ekin, const G4ParticleDefinition* particle,
+                                 const G4Material* material, G4double& restricted,
+                                 G4double& total)
+{
+  if (ekin < kEmin || ekin >= kEmax) {
+    restricted = fCalculator.GetDEDX(ekin, particle, material);
+    total = fCalculator.ComputeTotalDEDX(ekin, particle, material);
+    return;
+  }
+
+  const Table& table = GetTable(particle, material);
+  const G4double x = (std::log(ekin) - kLogEmin) * kInvLogStep;
+  const G4int bin = std::min(static_cast<G4int>(x), kNbBins - 1);
+  const G4double w = x - bin;
+  restricted = (1. - w) * table.fRestricted[bin] + w * table.fRestricted[bin + 1];
+  total = (1. - w) * table.fTotal[bin] + w * table.fTotal[bin + 1];
+
+  if (fCheckTolerance > 0.) Check(ekin, particle, material, restricted, total);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const StoppingPowerCache::Table&
+StoppingPowerCache::GetTable(const G4ParticleDefinition* particle, const G4Material* material)
+{
+  auto key = std::make_pair(particle, material);
+  auto it = fTables.find(key);
+  if (it != fTables.end()) return it->second;
+
+  Table& table = fTables[key];
+  table.fRestricted.resize(kNbBins + 1);
+  table.fTotal.resize(kNbBins + 1);
+  for (G4int i = 0; i <= kNbBins; ++i) {
+    G4double ekin = kEmin * std::pow(10., G4double(i) / kBinsPerDecade);
+    table.fRestricted[i] = fCalculator.GetDEDX(ekin, particle, material);
+    table.fTotal[i] = fCalculator.ComputeTotalDEDX(ekin, particle, material);
+  }
+  return table;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StoppingPowerCache::Check(G4double ekin, const G4ParticleDefinition* particle,
+                               const G4Material* material, G4double restricted,
+                               G4double total)
+{
+  const G4double exactRestricted = fCalculator.GetDEDX(ekin, particle, material);
+  const G4double exactTotal = fCalculator.ComputeTotalDEDX(ekin, particle, material);
+
+  auto deviation = [](G4double value, G4double exact) {
+    return (exact != 0.) ? std::abs(value / exact - 1.) : std::abs(value);
+  };
+  const G4double dRestricted = deviation(restricted, exactRestricted);
+  const G4double dTotal = deviation(total, exactTotal);
+  if (dRestricted <= fCheckTolerance && dTotal <= fCheckTolerance) return;
+
+  if (fNbCheckWarnings++ >= kMaxCheckWarnings) return;
+  G4cout << "\n--> warning from StoppingPowerCache : " << particle->GetParticleName() << " in "
+         << material->GetName() << " at " << ekin / MeV << " MeV : restricted dE/dx off by "
+         << 100. * dRestricted << " %, total dE/dx off by " << 100. * dTotal
+         << " % (tolerance " << 100. * fCheckTolerance << " %)" << G4endl;
+  if (fNbCheckWarnings == kMaxCheckWarnings)
+    G4cout << "--> further StoppingPowerCache warnings are suppressed" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,80 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file TrackInformation.cc
+/// \brief Implementation of the TrackInformation class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "TrackInformation.hh"
+
+#include "G4Gamma.hh"
+#include "G4Neutron.hh"
+
+G4ThreadLocal G4Allocator<TrackInformation>* TrackInformationAllocator = nullptr;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int TrackInformation::SecondaryAncestry(const G4Track* parent, G4int layer,
+                                          G4bool isB10Capture, G4bool isRadioactiveDecay)
+{
+  // everything but the direct parent flag is inherited
+  G4int ancestry = GetAncestry(parent) & ~kCreatedByPhoton;
+
+  const G4ParticleDefinition* particle = parent->GetDefinition();
+  if (particle == G4Neutron::Neutron()) {
+    ancestry |= kFromNeutron;
+    if (isB10Capture) ancestry |= kFromB10Capture;
+    // the interactions of the primary neutron tag the layer they happened in
+    if (parent->GetParentID() == 0) {
+      ancestry |= kFromPrimaryNeutron;
+      if (layer >= 0) ancestry |= ((layer + 1) << kLayerShift) & kLayerMask;
+    }
+  }
+  else if (particle == G4Gamma::Gamma()) {
+    ancestry |= kFromPhoton | kCreatedByPhoton;
+  }
+  if (isRadioactiveDecay) ancestry |= kFromRadioactiveDecay;
+
+  return ancestry;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void TrackInformation::Print() const
+{
+  G4cout << " Ancestry 0x" << std::hex << fAncestry << std::dec << " :"
+         << ((fAncestry & kFromB10Capture) ? " B10-capture" : "")
+         << ((fAncestry & kFromNeutron) ? " neutron" : "")
+         << ((fAncestry & kFromPrimaryNeutron) ? " primary-neutron" : "")
+         << ((fAncestry & kFromPhoton) ? " photon" : "")
+         << ((fAncestry & kCreatedByPhoton) ? " photon-parent" : "")
+         << ((fAncestry & kFromRadioactiveDecay) ? " radioactive-decay" : "")
+         << " layer " << GetLayer(fAncestry) << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
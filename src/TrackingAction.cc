@@ -32,25 +32,41 @@
 
 #include "TrackingAction.hh"
 
+#include "DetectorConstruction.hh"
 #include "EventAction.hh"
 #include "HistoManager.hh"
+#include "ParticleClassifier.hh"
+#include "ProcessClassifier.hh"
 #include "Run.hh"
+#include "StepNames.hh"
+#include "TrackInformation.hh"
+
+#include "G4EmProcessSubType.hh"
+#include "G4Event.hh"
 
-#include "G4ParticleTypes.hh"
 #include "G4RunManager.hh"
 #include "G4StepStatus.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4Track.hh"
 #include "G4UnitsTable.hh"
-#include <fstream>
+
+#include <cmath>
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-TrackingAction::TrackingAction(EventAction *event) : fEventAction(event) {}
+TrackingAction::TrackingAction(DetectorConstruction *det, EventAction *event)
+    : fDetector(det), fEventAction(event) {}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 void TrackingAction::PreUserTrackingAction(const G4Track *track) {
+  // the summary row is filled by the steps of this track
+  TrackSummaryRow *summary = fEventAction->GetTrackSummary();
+  if (summary != nullptr)
+    *summary = TrackSummaryRow();
+  if (TrajectoryStore *trajectories = fEventAction->GetTrajectoryStore())
+    trajectories->StartTrack(track);
+
   // count secondary particles
   if (track->GetTrackID() == 1)
     return;
@@ -58,267 +74,145 @@ void TrackingAction::PreUserTrackingAction(const G4Track *track) {
   Run *run = static_cast<Run *>(
       G4RunManager::GetRunManager()->GetNonConstCurrentRun());
 
-  G4String name = track->GetDefinition()->GetParticleName();
-  G4double meanLife = track->GetDefinition()->GetPDGLifeTime();
+  const G4ParticleDefinition *particle = track->GetDefinition();
+  G4double meanLife = particle->GetPDGLifeTime();
   G4double energy = track->GetKineticEnergy();
   if (meanLife != 0)
-    run->ParticleCount(name, energy, meanLife);
+    run->ParticleCount(particle, energy, meanLife, track->GetWeight());
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 void TrackingAction::PostUserTrackingAction(const G4Track *track) {
+  TrackSummaryRow *summary = fEventAction->GetTrackSummary();
+  if (summary != nullptr) {
+    EndTrackSummary(track, *summary);
+    fEventAction->StageTrackSummary();
+  }
+  if (TrajectoryStore *trajectories = fEventAction->GetTrajectoryStore())
+    trajectories->EndTrack(track);
+
   // keep only outgoing particle
   G4StepStatus status = track->GetStep()->GetPostStepPoint()->GetStepStatus();
   if (status != fWorldBoundary)
     return;
 
   const G4ParticleDefinition *particle = track->GetParticleDefinition();
-  G4String name = particle->GetParticleName();
   G4double energy = track->GetKineticEnergy();
+  // every tally and histogram is weighted by the track weight
+  const G4double weight = track->GetWeight();
 
-  fEventAction->AddEflow(energy);
+  fEventAction->AddEflow(energy * weight);
 
   Run *run = static_cast<Run *>(
       G4RunManager::GetRunManager()->GetNonConstCurrentRun());
-  run->ParticleFlux(name, energy);
-
-  // const G4ThreeVector& postStepPosition =
-  // track->GetStep()->GetPostStepPoint()->GetPosition();
+  run->ParticleFlux(particle, energy, weight);
+  if (particle == fEventAction->GetMonitoredParticle())
+    fEventAction->AddTallyValue(weight);
 
-  // std::cout << "Particle Pos:" << "x = " << postStepPosition.x() << ", y = "
-  // << postStepPosition.y()
-  //           << ", z = " << postStepPosition.z() << G4endl;
-
-  // histograms: enery flow
+  // histograms: energy spectrum (H1) and position on the world face (H2),
+  // per particle category and face, see HistoManager
   //
-  G4AnalysisManager *analysis = G4AnalysisManager::Instance();
+  const ParticleClassifier::Category category =
+      ParticleClassifier::Instance()->Classify(particle);
+  if (category == ParticleClassifier::kUnclassified)
+    return;
 
-  G4int ih = 0;
-  G4String type = particle->GetParticleType();
-  G4double charge = particle->GetPDGCharge();
-  if (charge > 3.)
-    ih = 10;
-  else if (particle == G4Gamma::Gamma())
-    ih = 4;
-  else if (particle == G4Electron::Electron())
-    ih = 5;
-  else if (particle == G4Positron::Positron())
-    ih = 5;
-  else if (particle == G4Neutron::Neutron())
-    ih = 6;
-  else if (particle == G4Proton::Proton())
-    ih = 7;
-  else if (particle == G4Deuteron::Deuteron())
-    ih = 8;
-  else if (particle == G4Alpha::Alpha())
-    ih = 9;
-  else if (type == "nucleus")
-    ih = 10;
-  else if (type == "baryon")
-    ih = 11;
-  else if (type == "meson")
-    ih = 12;
-  else if (type == "lepton")
-    ih = 13;
-  if (ih > 0)
-    analysis->FillH1(ih, energy);
+  const G4ThreeVector &position =
+      track->GetStep()->GetPostStepPoint()->GetPosition();
+  const Face face = GetExitFace(position);
+  static_assert(kNbFaces == HistoManager::kNbFaces, "one flux histogram per face");
+  const G4int ih = category + ParticleClassifier::kNbCategories * face;
 
-  //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
-  // Track positions
-  G4double posX = track->GetStep()->GetPostStepPoint()->GetPosition().x();
-  G4double posY = track->GetStep()->GetPostStepPoint()->GetPosition().y();
-  G4double posZ = track->GetStep()->GetPostStepPoint()->GetPosition().z();
+  // the per-face spectra and the maps exist once their binning is set
+  G4AnalysisManager *analysis = G4AnalysisManager::Instance();
+  const HistoManager *histo = HistoManager::Instance();
+  if (histo == nullptr)
+    return;
+  if (histo->HasLogSpectra()) {
+    run->FillSpectrum(HistoManager::kFirstSpectrum + category, energy, weight);
+    run->FillSpectrum(HistoManager::kFirstFaceSpectrum + ih, energy, weight);
+  } else {
+    analysis->FillH1(HistoManager::kFirstSpectrum + category, energy, weight);
+    if (histo->HasFaceSpectra())
+      analysis->FillH1(HistoManager::kFirstFaceSpectrum + ih, energy, weight);
+  }
+  if (!histo->HasSparseMaps() && !histo->HasDenseMaps())
+    return;
 
-  G4double preX = track->GetStep()->GetPreStepPoint()->GetPosition().x();
-  G4double preY = track->GetStep()->GetPreStepPoint()->GetPosition().y();
-  G4double preZ = track->GetStep()->GetPreStepPoint()->GetPosition().z();
+  G4double u = position.z(), v = position.x();
+  if (face == kMinusZ || face == kPlusZ) {
+    u = position.x();
+    v = position.y();
+  } else if (face == kMinusX || face == kPlusX) {
+    v = position.y();
+  }
+  if (histo->HasSparseMaps())
+    run->FillFluxMap(ih, u, v, weight);
+  else
+    analysis->FillH2(ih, u, v, weight);
+}
 
-  // std::cout << name << " :" << "x = " << posX << " (" << preX << ") "
-  //           << ", y = " << posY << " (" << preY << ") " << ", z = " << posZ
-  //           << " (" << preZ << ") " << G4endl;
-  const G4int kHisto2D = 6;
-  const G4int kPArticleHisto2D = 10;
-  ih = -1;
-  //&& posX <= 500. && posX >= -500. && posY <= 500. && posY >= -500.
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-  // for (G4int i = 0; i < kHisto2D; i++) {
-  //   for (G4int j = 0; j < kPArticleHisto2D; j++) {
-  if (posZ <= -500.) {
-    if (particle == G4Gamma::Gamma())
-      ih = 0;
-    else if (particle == G4Electron::Electron() ||
-             particle == G4Positron::Positron())
-      ih = 1;
-    else if (particle == G4Neutron::Neutron())
-      ih = 2;
-    else if (particle == G4Proton::Proton())
-      ih = 3;
-    else if (particle == G4Deuteron::Deuteron())
-      ih = 4;
-    else if (particle == G4Alpha::Alpha())
-      ih = 5;
-    else if (type == "nucleus" || charge > 3.)
-      ih = 6;
-    else if (type == "baryon")
-      ih = 7;
-    else if (type == "meson")
-      ih = 8;
-    else if (type == "lepton")
-      ih = 9;
-    if (ih >= 0)
-      analysis->FillH2(ih, posX, posY, 1);
-  }
-  if (posZ >= 500.) {
-    if (particle == G4Gamma::Gamma())
-      ih = 0 + kPArticleHisto2D;
-    else if (particle == G4Electron::Electron() ||
-             particle == G4Positron::Positron())
-      ih = 1 + kPArticleHisto2D;
-    else if (particle == G4Neutron::Neutron())
-      ih = 2 + kPArticleHisto2D;
-    else if (particle == G4Proton::Proton())
-      ih = 3 + kPArticleHisto2D;
-    else if (particle == G4Deuteron::Deuteron())
-      ih = 4 + kPArticleHisto2D;
-    else if (particle == G4Alpha::Alpha())
-      ih = 5 + kPArticleHisto2D;
-    else if (type == "nucleus" || charge > 3.)
-      ih = 6 + kPArticleHisto2D;
-    else if (type == "baryon")
-      ih = 7 + kPArticleHisto2D;
-    else if (type == "meson")
-      ih = 8 + kPArticleHisto2D;
-    else if (type == "lepton")
-      ih = 9 + kPArticleHisto2D;
-    if (ih > 0)
-      analysis->FillH2(ih, posX, posY, 1);
-  }
-  if (posX <= -500.) {
-    if (particle == G4Gamma::Gamma())
-      ih = 0 + kPArticleHisto2D * 2;
-    else if (particle == G4Electron::Electron() ||
-             particle == G4Positron::Positron())
-      ih = 1 + kPArticleHisto2D * 2;
-    else if (particle == G4Neutron::Neutron())
-      ih = 2 + kPArticleHisto2D * 2;
-    else if (particle == G4Proton::Proton())
-      ih = 3 + kPArticleHisto2D * 2;
-    else if (particle == G4Deuteron::Deuteron())
-      ih = 4 + kPArticleHisto2D * 2;
-    else if (particle == G4Alpha::Alpha())
-      ih = 5 + kPArticleHisto2D * 2;
-    else if (type == "nucleus" || charge > 3.)
-      ih = 6 + kPArticleHisto2D * 2;
-    else if (type == "baryon")
-      ih = 7 + kPArticleHisto2D * 2;
-    else if (type == "meson")
-      ih = 8 + kPArticleHisto2D * 2;
-    else if (type == "lepton")
-      ih = 9 + kPArticleHisto2D * 2;
-    if (ih > 0)
-      analysis->FillH2(ih, posZ, posY, 1);
-  }
-  if (posX >= 500.) {
-    if (particle == G4Gamma::Gamma())
-      ih = 0 + kPArticleHisto2D * 3;
-    else if (particle == G4Electron::Electron() ||
-             particle == G4Positron::Positron())
-      ih = 1 + kPArticleHisto2D * 3;
-    else if (particle == G4Neutron::Neutron())
-      ih = 2 + kPArticleHisto2D * 3;
-    else if (particle == G4Proton::Proton())
-      ih = 3 + kPArticleHisto2D * 3;
-    else if (particle == G4Deuteron::Deuteron())
-      ih = 4 + kPArticleHisto2D * 3;
-    else if (particle == G4Alpha::Alpha())
-      ih = 5 + kPArticleHisto2D * 3;
-    else if (type == "nucleus" || charge > 3.)
-      ih = 6 + kPArticleHisto2D * 3;
-    else if (type == "baryon")
-      ih = 7 + kPArticleHisto2D * 3;
-    else if (type == "meson")
-      ih = 8 + kPArticleHisto2D * 3;
-    else if (type == "lepton")
-      ih = 9 + kPArticleHisto2D * 3;
-    if (ih > 0)
-      analysis->FillH2(ih, posZ, posY, 1);
+TrackingAction::Face
+TrackingAction::GetExitFace(const G4ThreeVector &position) {
+  // The track is on the world boundary: the face is the one of the axis
+  // along which it is the closest to the half size
+  const G4double ratio[3] = {
+      std::abs(position.x()) / (0.5 * fDetector->GetWorldSizeX()),
+      std::abs(position.y()) / (0.5 * fDetector->GetWorldSizeY()),
+      std::abs(position.z()) / (0.5 * fDetector->GetWorldSizeZ())};
+
+  if (ratio[2] >= ratio[0] && ratio[2] >= ratio[1])
+    return (position.z() < 0.) ? kMinusZ : kPlusZ;
+  if (ratio[0] >= ratio[1])
+    return (position.x() < 0.) ? kMinusX : kPlusX;
+  return (position.y() < 0.) ? kMinusY : kPlusY;
+}
 
-    // std::cout << "ih = " << ih << " posX = " << posX << " posY = " << posY
-    //           << " posZ = " << posZ << G4endl;
-  }
-  if (posY <= -500.) {
-    if (particle == G4Gamma::Gamma())
-      ih = 0 + kPArticleHisto2D * 4;
-    else if (particle == G4Electron::Electron() ||
-             particle == G4Positron::Positron())
-      ih = 1 + kPArticleHisto2D * 4;
-    else if (particle == G4Neutron::Neutron())
-      ih = 2 + kPArticleHisto2D * 4;
-    else if (particle == G4Proton::Proton())
-      ih = 3 + kPArticleHisto2D * 4;
-    else if (particle == G4Deuteron::Deuteron())
-      ih = 4 + kPArticleHisto2D * 4;
-    else if (particle == G4Alpha::Alpha())
-      ih = 5 + kPArticleHisto2D * 4;
-    else if (type == "nucleus" || charge > 3.)
-      ih = 6 + kPArticleHisto2D * 4;
-    else if (type == "baryon")
-      ih = 7 + kPArticleHisto2D * 4;
-    else if (type == "meson")
-      ih = 8 + kPArticleHisto2D * 4;
-    else if (type == "lepton")
-      ih = 9 + kPArticleHisto2D * 4;
-    if (ih > 0)
-      analysis->FillH2(ih, posZ, posX, 1);
-  }
-  if (posY >= 500.) {
-    if (particle == G4Gamma::Gamma())
-      ih = 0 + kPArticleHisto2D * 5;
-    else if (particle == G4Electron::Electron() ||
-             particle == G4Positron::Positron())
-      ih = 1 + kPArticleHisto2D * 5;
-    else if (particle == G4Neutron::Neutron())
-      ih = 2 + kPArticleHisto2D * 5;
-    else if (particle == G4Proton::Proton())
-      ih = 3 + kPArticleHisto2D * 5;
-    else if (particle == G4Deuteron::Deuteron())
-      ih = 4 + kPArticleHisto2D * 5;
-    else if (particle == G4Alpha::Alpha())
-      ih = 5 + kPArticleHisto2D * 5;
-    else if (type == "nucleus" || charge > 3.)
-      ih = 6 + kPArticleHisto2D * 5;
-    else if (type == "baryon")
-      ih = 7 + kPArticleHisto2D * 5;
-    else if (type == "meson")
-      ih = 8 + kPArticleHisto2D * 5;
-    else if (type == "lepton")
-      ih = 9 + kPArticleHisto2D * 5;
-    if (ih > 0)
-      analysis->FillH2(ih, posZ, posX, 1);
-  }
-  // }
-  // }
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-  // if (posZ < 0) {
-  //   analysis->FillH2(0, posX, posY, 1);
-  // }
-  // if (posZ > 0) {
-  //   analysis->FillH2(1, posX, posY, 1);
-  // }
-  // if (posX < 0) {
-  //   analysis->FillH2(2, posZ, posY, 1);
-  // }
-  // if (posX > 0) {
-  //   analysis->FillH2(3, posZ, posY, 1);
-  // }
-  // if (posY < 0) {
-  //   analysis->FillH2(4, posZ, posX, 1);
-  // }
-  // if (posY > 0) {
-  //   analysis->FillH2(5, posZ, posX, 1);
-  // }
-  //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void TrackingAction::EndTrackSummary(const G4Track *track,
+                                     TrackSummaryRow &row) {
+  // The vertex of a track is set when its first step is prepared, after
+  // PreUserTrackingAction: everything is read here
+  const G4StepPoint *endPoint = track->GetStep()->GetPostStepPoint();
+  const G4VProcess *endProcess = endPoint->GetProcessDefinedStep();
+  const G4ThreeVector &vertex = track->GetVertexPosition();
+  const G4ThreeVector &end = track->GetPosition();
+
+  row.fEvent = G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID();
+  row.fParticleName = &track->GetDefinition()->GetParticleName();
+  row.fParentID = track->GetParentID();
+  row.fParticleID = track->GetTrackID();
+  row.fVertexX = vertex.x() / mm;
+  row.fVertexY = vertex.y() / mm;
+  row.fVertexZ = vertex.z() / mm;
+  row.fVertexVolumeName = &track->GetLogicalVolumeAtVertex()->GetName();
+  row.fCreatorProcessName = &StepNames::Creator(track);
+  row.fVertexKinEnergy = track->GetVertexKineticEnergy() / MeV;
+  row.fEndX = end.x() / mm;
+  row.fEndY = end.y() / mm;
+  row.fEndZ = end.z() / mm;
+  row.fEndKinEnergy = track->GetKineticEnergy() / MeV;
+  row.fTrackLength = track->GetTrackLength() / mm;
+  row.fNbSteps = track->GetCurrentStepNumber();
+  row.fFateProcessName = &StepNames::Process(endProcess);
+  row.fAncestry = TrackInformation::GetAncestry(track);
+  row.fWeight = track->GetWeight();
+
+  const ProcessInfo &info = ProcessClassifier::Instance()->Classify(endProcess);
+  if (endPoint->GetStepStatus() == fWorldBoundary)
+    row.fFate = TrackSummaryRow::kEscaped;
+  else if (info.fCategory == fDecay)
+    row.fFate = TrackSummaryRow::kDecayed;
+  else if (info.fCategory == fGeneral)
+    row.fFate = TrackSummaryRow::kKilled;
+  else if (info.fCategory == fElectromagnetic && info.fSubType == fIonisation)
+    row.fFate = TrackSummaryRow::kStopped;
+  else
+    row.fFate = TrackSummaryRow::kInteracted;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
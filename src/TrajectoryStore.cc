@@ -0,0 +1,212 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file TrajectoryStore.cc
+/// \brief Implementation of the TrajectoryStore class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "TrajectoryStore.hh"
+
+#include "G4Event.hh"
+#include "G4GenericMessenger.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4Step.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Track.hh"
+
+#include <algorithm>
+#include <iomanip>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+TrajectoryStore::TrajectoryStore()
+{
+  DefineCommands();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+TrajectoryStore::~TrajectoryStore()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void TrajectoryStore::SetNbEvents(G4int n)
+{
+  fRing.clear();
+  fRing.resize(std::max(n, 0));
+  fNext = 0;
+  fNbKept = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void TrajectoryStore::SetStride(G4int k)
+{
+  fStride = std::max(k, 1);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void TrajectoryStore::BeginOfEvent(const G4Event* event)
+{
+  fCurrent.fEventID = event->GetEventID();
+  fCurrent.fTrajectories.clear();
+  fCurrent.fPoints.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void TrajectoryStore::AddPoint(const G4Track* track)
+{
+  const G4ThreeVector& position = track->GetPosition();
+  Point point;
+  point.fX = static_cast<G4float>(position.x() / mm);
+  point.fY = static_cast<G4float>(position.y() / mm);
+  point.fZ = static_cast<G4float>(position.z() / mm);
+  point.fKinEnergy = static_cast<G4float>(track->GetKineticEnergy() / MeV);
+  fCurrent.fPoints.push_back(point);
+  ++fCurrent.fTrajectories.back().fNbPoints;
+  fStepsSincePoint = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void TrajectoryStore::StartTrack(const G4Track* track)
+{
+  // Tracks are processed one at a time, the current one is always the last
+  Trajectory trajectory;
+  trajectory.fTrackID = track->GetTrackID();
+  trajectory.fParentID = track->GetParentID();
+  trajectory.fParticle = track->GetDefinition();
+  trajectory.fFirstPoint = static_cast<std::uint32_t>(fCurrent.fPoints.size());
+  fCurrent.fTrajectories.push_back(trajectory);
+  AddPoint(track);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void TrajectoryStore::AddStep(const G4Step* step)
+{
+  // The track is already at the post-step point
+  if (++fStepsSincePoint >= fStride) AddPoint(step->GetTrack());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void TrajectoryStore::EndTrack(const G4Track* track)
+{
+  // The last point, unless the last step was already sampled
+  if (fStepsSincePoint > 0) AddPoint(track);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void TrajectoryStore::EndOfEvent(const G4Event* event, G4bool fired)
+{
+  if (fTriggeredOnly && !fired) return;
+
+  // The evicted event goes back to fCurrent and its capacity is reused
+  std::swap(fRing[fNext], fCurrent);
+  fNext = (fNext + 1) % fRing.size();
+  fNbKept = std::min(fNbKept + 1, fRing.size());
+
+  if (fDumpOnFlag && (fired || event->ToBeKept())) {
+    G4cout << "\n--------- Trajectories, event " << event->GetEventID()
+           << " flagged ---------" << G4endl;
+    Dump();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void TrajectoryStore::Dump()
+{
+  // Oldest event first
+  const std::size_t size = fRing.size();
+  for (std::size_t i = 0; i < fNbKept; ++i) {
+    const EventTrajectories& event = fRing[(fNext + size - fNbKept + i) % size];
+    G4cout << "\n Event " << event.fEventID << " : " << event.fTrajectories.size()
+           << " tracks, " << event.fPoints.size() << " points (x y z in mm, Ekin in MeV)"
+           << G4endl;
+
+    for (const Trajectory& trajectory : event.fTrajectories) {
+      G4cout << "  track " << trajectory.fTrackID << " parent " << trajectory.fParentID << " "
+             << trajectory.fParticle->GetParticleName() << G4endl;
+      for (std::uint32_t p = 0; p < trajectory.fNbPoints; ++p) {
+        const Point& point = event.fPoints[trajectory.fFirstPoint + p];
+        G4cout << "    " << std::setw(11) << point.fX << " " << std::setw(11) << point.fY
+               << " " << std::setw(11) << point.fZ << " " << std::setw(11) << point.fKinEnergy
+               << G4endl;
+      }
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void TrajectoryStore::DefineCommands()
+{
+  // Each thread has its own store, the commands are broadcast to the workers
+  fMessenger =
+    new G4GenericMessenger(this, "/stepping/trajectory/", "compact trajectories of the last events");
+
+  auto& nbEventsCmd = fMessenger->DeclareMethod("keepEvents", &TrajectoryStore::SetNbEvents);
+  nbEventsCmd.SetGuidance("Keep the trajectories of the last N events of each thread.");
+  nbEventsCmd.SetGuidance("0 turns the store off.");
+  nbEventsCmd.SetParameterName("N", false);
+  nbEventsCmd.SetRange("N>=0");
+  nbEventsCmd.SetStates(G4State_PreInit, G4State_Idle);
+
+  auto& strideCmd = fMessenger->DeclareMethod("stride", &TrajectoryStore::SetStride);
+  strideCmd.SetGuidance("Keep one step point out of k, plus the first and last points.");
+  strideCmd.SetParameterName("k", false);
+  strideCmd.SetRange("k>=1");
+  strideCmd.SetStates(G4State_PreInit, G4State_Idle);
+
+  auto& triggeredCmd = fMessenger->DeclareProperty("triggeredOnly", fTriggeredOnly);
+  triggeredCmd.SetGuidance("Keep only the events passing the /stepping/ triggers.");
+  triggeredCmd.SetParameterName("flag", false);
+  triggeredCmd.SetStates(G4State_PreInit, G4State_Idle);
+
+  auto& dumpOnFlagCmd = fMessenger->DeclareProperty("dumpOnFlag", fDumpOnFlag);
+  dumpOnFlagCmd.SetGuidance("Print the buffer when an event passes the /stepping/ triggers");
+  dumpOnFlagCmd.SetGuidance("or is marked to be kept.");
+  dumpOnFlagCmd.SetParameterName("flag", false);
+  dumpOnFlagCmd.SetStates(G4State_PreInit, G4State_Idle);
+
+  auto& dumpCmd = fMessenger->DeclareMethod("dump", &TrajectoryStore::Dump);
+  dumpCmd.SetGuidance("Print the trajectories in the buffer of each thread.");
+  dumpCmd.SetGuidance("In MT the workers only execute it at the start of the next run,");
+  dumpCmd.SetGuidance("use dumpOnFlag to print the buffers during a run.");
+  dumpCmd.SetStates(G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......